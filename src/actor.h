@@ -622,6 +622,23 @@ struct FLinkContext
 	msecnode_t *render_list = nullptr;
 };
 
+// Remembers how far an actor may move before the result of
+// P_CreateSecNodeList can change so that the blockmap does not need to be
+// checked again for short moves.
+struct FSecNodeCache
+{
+	msecnode_t *List;
+	sector_t *Sector;
+	DVector2 Pos;
+	double Radius;
+	double Slack;			// distance along either axis that is safe to move
+
+	void Clear()
+	{
+		List = nullptr;
+	}
+};
+
 struct FDropItem
 {
 	FDropItem *Next;
@@ -1052,6 +1069,7 @@ public:
 
 // interaction info
 	FBlockNode		*BlockNode;			// links in blocks (if needed)
+	uint64_t		BlockStamps[4];		// used by FBlockThingsIterator to skip actors it has already returned
 	struct sector_t	*Sector;
 	subsector_t *		subsector;
 	FSection *			section;
@@ -1124,7 +1142,7 @@ public:
 
 	int		accuracy, stamina;		// [RH] Strife stats -- [XA] moved here for DECORATE/ACS access.
 
-	AActor			*inext, **iprev;// Links to other mobjs in same bucket
+	unsigned		TIDIndex;		// position in the level's bucket for this TID
 	TObjPtr<AActor*> goal;			// Monster's goal if not chasing anything
 	int				waterlevel;		// 0=none, 1=feet, 2=waist, 3=eyes
 	uint8_t			boomwaterlevel;	// splash information for non-swimmable water sectors
@@ -1174,6 +1192,8 @@ public:
 	struct msecnode_t	*touching_sectorportallist;		// same for cross-sectorportal rendering
 	struct portnode_t	*touching_lineportallist;		// and for cross-lineportal
 	struct msecnode_t	*touching_rendersectors; // this is the list of sectors that this thing interesects with it's max(radius, renderradius).
+	FSecNodeCache		SectorListCache;		// for touching_sectorlist
+	FSecNodeCache		RenderListCache;		// for touching_rendersectors
 	int validcount;
 
 
@@ -1182,6 +1202,8 @@ public:
 
 	uint8_t smokecounter;
 	uint8_t FloatBobPhase;
+	uint8_t LODPeriod;					// tics between two full ticks of an idle monster far from all players
+	uint8_t LODSkipped;					// tics skipped since the last full tick
 	double FloatBobStrength;
 	uint8_t FriendPlayer;				// [RH] Player # + 1 this friendly monster works for (so 0 is no player, 1 is player 0, etc)
 	PalEntry BloodColor;
@@ -1245,14 +1267,13 @@ public:
 	void RemoveFromHash ();
 
 
-private:
-	static inline int TIDHASH (int key) { return key & 127; }
 public:
 	static FSharedStringArena mStringPropertyData;
 private:
 	friend class FActorIterator;
 
 	bool FixMapthingPos();
+	bool SkipLODTick();
 
 public:
 	void LinkToWorld (FLinkContext *ctx, bool spawningmapthing=false, sector_t *sector = NULL);
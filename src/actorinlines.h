@@ -4,6 +4,7 @@
 #include "r_defs.h"
 #include "g_levellocals.h"
 #include "d_player.h"
+#include <algorithm>
 // These depend on both actor.h and r_defs.h so they cannot be in either file without creating a circular dependency.
 
 inline DVector3 AActor::PosRelative(int portalgroup) const
@@ -121,24 +122,43 @@ inline bool AActor::isFrozen()
 class FActorIterator
 {
 public:
-	FActorIterator (FLevelLocals *l, int i) : Level(l), base (nullptr), id (i)
+	FActorIterator (FLevelLocals *l, int i) : Level(l), base (nullptr), seq (0), id (i)
 	{
 	}
-	FActorIterator (FLevelLocals *l, int i, AActor *start) : Level(l), base (start), id (i)
+	FActorIterator (FLevelLocals *l, int i, AActor *start) : Level(l), base (start), seq (0), id (i)
 	{
 	}
+	// Returns the actors with this TID from the most recently added one to
+	// the oldest. If the last returned actor lost its TID in the meantime,
+	// this continues with the actors that were added before it, even if
+	// the bucket got compacted since.
 	AActor *Next ()
 	{
 		if (id == 0)
 			return nullptr;
+
+		auto bucket = Level->TIDHash.CheckKey(id);
+		if (bucket == nullptr)
+			return base = nullptr;
+
+		auto &actors = bucket->Actors;
+		unsigned pos;
 		if (!base)
-			base = Level->TIDHash[id & 127];
+			pos = actors.Size();
+		else if (base->tid == id && base->TIDIndex < actors.Size() && actors[base->TIDIndex].Actor == base)
+			pos = base->TIDIndex;
 		else
-			base = base->inext;
+			pos = unsigned(std::lower_bound(actors.begin(), actors.end(), seq,
+				[](const FTIDBucket::Entry &e, uint64_t s) { return e.Seq < s; }) - actors.begin());
 
-		while (base && base->tid != id)
-			base = base->inext;
+		do
+		{
+			if (pos == 0)
+				return base = nullptr;
+		} while (actors[--pos].Actor == nullptr);
 
+		base = actors[pos].Actor;
+		seq = actors[pos].Seq;
 		return base;
 	}
 	void Reinit()
@@ -149,6 +169,7 @@ public:
 private:
 	FLevelLocals *Level;
 	AActor *base;
+	uint64_t seq;
 	int id;
 };
 
@@ -65,6 +65,111 @@ FBaseCVar *CVars = NULL;
 
 int cvar_defflags;
 
+// Bumped whenever a cvar gets created or deleted so that cached lookups,
+// including failed ones, can be checked.
+static int CVarGeneration = 1;
+
+//===========================================================================
+//
+// CVar lookup table
+//
+// Linear probing table of the cvars that FindCVar returns, keyed by the
+// case insensitive hash of their names. The CVars list is still the
+// authority, this only exists to speed up the lookups. It only uses plain
+// statics because cvars get created during static initialization.
+//
+//===========================================================================
+
+static FBaseCVar **CVarTable;
+static unsigned CVarTableSize;		// always a power of 2
+static unsigned CVarTableCount;
+
+static unsigned CVarTableFind (const char *name, size_t namelen)
+{
+	unsigned mask = CVarTableSize - 1;
+	unsigned slot = MakeKey (name, namelen) & mask;
+
+	while (CVarTable[slot] != NULL)
+	{
+		const char *probename = CVarTable[slot]->GetName();
+		if (strnicmp (probename, name, namelen) == 0 && probename[namelen] == 0)
+		{
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+static void CVarTableInsert (FBaseCVar *var);
+
+static void CVarTableGrow ()
+{
+	FBaseCVar **oldtable = CVarTable;
+	unsigned oldsize = CVarTableSize;
+
+	CVarTableSize = oldsize == 0 ? 1024 : oldsize * 2;
+	CVarTable = new FBaseCVar *[CVarTableSize];
+	memset (CVarTable, 0, CVarTableSize * sizeof(FBaseCVar *));
+	CVarTableCount = 0;
+
+	for (unsigned i = 0; i < oldsize; i++)
+	{
+		if (oldtable[i] != NULL)
+		{
+			CVarTableInsert (oldtable[i]);
+		}
+	}
+	delete[] oldtable;
+}
+
+// Replaces the entry for a cvar with the same name.
+static void CVarTableInsert (FBaseCVar *var)
+{
+	if ((CVarTableCount + 1) * 2 > CVarTableSize)
+	{
+		CVarTableGrow ();
+	}
+	const char *name = var->GetName();
+	unsigned slot = CVarTableFind (name, strlen (name));
+	if (CVarTable[slot] == NULL)
+	{
+		CVarTableCount++;
+	}
+	CVarTable[slot] = var;
+}
+
+static void CVarTableRemove (FBaseCVar *var)
+{
+	if (CVarTableSize == 0)
+	{
+		return;
+	}
+	const char *name = var->GetName();
+	unsigned mask = CVarTableSize - 1;
+	unsigned slot = CVarTableFind (name, strlen (name));
+	if (CVarTable[slot] != var)
+	{
+		return;
+	}
+
+	// Move the following entries of the cluster back if this slot is
+	// between their home slot and where they are now.
+	unsigned hole = slot;
+	for (unsigned next = (slot + 1) & mask; CVarTable[next] != NULL; next = (next + 1) & mask)
+	{
+		const char *nextname = CVarTable[next]->GetName();
+		unsigned home = MakeKey (nextname) & mask;
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			CVarTable[hole] = CVarTable[next];
+			hole = next;
+		}
+	}
+	CVarTable[hole] = NULL;
+	CVarTableCount--;
+}
+
 FBaseCVar::FBaseCVar (const char *var_name, uint32_t flags, void (*callback)(FBaseCVar &))
 {
 	if (var_name != nullptr && (flags & CVAR_SERVERINFO))
@@ -94,6 +199,8 @@ FBaseCVar::FBaseCVar (const char *var_name, uint32_t flags, void (*callback)(FBa
 		Name = copystring (var_name);
 		m_Next = CVars;
 		CVars = this;
+		CVarTableInsert (this);
+		CVarGeneration++;
 	}
 
 	if (var)
@@ -131,10 +238,19 @@ FBaseCVar::~FBaseCVar ()
 				prev->m_Next = m_Next;
 			else
 				CVars = m_Next;
+
+			// An older cvar with the same name may still be in the list.
+			CVarTableRemove (this);
+			var = FindCVar (Name, &prev);
+			if (var != NULL)
+			{
+				CVarTableInsert (var);
+			}
 		}
 		C_RemoveTabCommand(Name);
 		delete[] Name;
 	}
+	CVarGeneration++;
 }
 
 const char *FBaseCVar::GetHumanString(int precision) const
@@ -1567,13 +1683,14 @@ void C_ForgetCVars (void)
 FBaseCVar *FindCVar (const char *var_name, FBaseCVar **prev)
 {
 	FBaseCVar *var;
-	FBaseCVar *dummy;
 
 	if (var_name == NULL)
 		return NULL;
 
 	if (prev == NULL)
-		prev = &dummy;
+	{
+		return CVarTableSize == 0 ? NULL : CVarTable[CVarTableFind (var_name, strlen (var_name))];
+	}
 
 	var = CVars;
 	*prev = NULL;
@@ -1594,6 +1711,12 @@ DEFINE_ACTION_FUNCTION(_CVar, FindCVar)
 	ACTION_RETURN_POINTER(FindCVar(name, nullptr));
 }
 
+DEFINE_ACTION_FUNCTION(_CVar, GetGeneration)
+{
+	PARAM_PROLOGUE;
+	ACTION_RETURN_INT(CVarGeneration);
+}
+
 DEFINE_ACTION_FUNCTION(_CVar, GetCVar)
 {
 	PARAM_PROLOGUE;
@@ -1604,24 +1727,10 @@ DEFINE_ACTION_FUNCTION(_CVar, GetCVar)
 
 FBaseCVar *FindCVarSub (const char *var_name, int namelen)
 {
-	FBaseCVar *var;
-
-	if (var_name == NULL)
+	if (var_name == NULL || CVarTableSize == 0)
 		return NULL;
 
-	var = CVars;
-	while (var)
-	{
-		const char *probename = var->GetName ();
-
-		if (strnicmp (probename, var_name, namelen) == 0 &&
-			probename[namelen] == 0)
-		{
-			break;
-		}
-		var = var->m_Next;
-	}
-	return var;
+	return CVarTable[CVarTableFind (var_name, namelen)];
 }
 
 FBaseCVar *GetCVar(AActor *activator, const char *cvarname)
@@ -100,6 +100,8 @@
 #include "vm.h"
 #include "types.h"
 #include "r_data/r_vanillatrans.h"
+#include "g_benchmark.h"
+#include "d_startuptimer.h"
 
 EXTERN_CVAR(Bool, hud_althud)
 EXTERN_CVAR(Int, vr_mode)
@@ -645,6 +647,8 @@ void D_Display ()
 
 	if (nodrawers || screen == NULL)
 		return; 				// for comparative timing / profiling
+
+	FTraceScope trace("D_Display");
 	
 	if (!AppActive && (screen->IsFullscreen() || !vid_activeinbackground))
 	{
@@ -1000,6 +1004,7 @@ void D_DoomLoop ()
 				gametic++;
 				maketic++;
 				GC::CheckGC ();
+				BM_Tic ();
 				Net_NewMakeTic ();
 			}
 			else
@@ -2247,6 +2252,8 @@ void D_DoomMain (void)
 	FIWadManager *iwad_man;
 	const char *batchout = Args->CheckValue("-errorlog");
 
+	D_InitStartupTimer();
+
 	// +logfile gets checked too late to catch the full startup log in the logfile so do some extra check for it here.
 	FString logfile = Args->TakeValue("+logfile");
 	if (logfile.IsNotEmpty())
@@ -2287,7 +2294,11 @@ void D_DoomMain (void)
 
 	if (!batchrun) Printf(PRINT_LOG, "%s version %s\n", GAMENAME, GetVersionString());
 
-	D_DoomInit();
+	{
+		FStartupPhase phase("D_DoomInit");
+		D_DoomInit();
+	}
+	BM_Init();
 
 	extern void D_ConfirmSendStats();
 	D_ConfirmSendStats();
@@ -2382,7 +2393,10 @@ void D_DoomMain (void)
 		}
 
 		if (!batchrun) Printf ("W_Init: Init WADfiles.\n");
-		Wads.InitMultipleFiles (allwads);
+		{
+			FStartupPhase phase("W_Init");
+			Wads.InitMultipleFiles (allwads);
+		}
 		allwads.Clear();
 		allwads.ShrinkToFit();
 		SetMapxxFlag();
@@ -2413,17 +2427,26 @@ void D_DoomMain (void)
 		if (!restart)
 		{
 			if (!batchrun) Printf ("I_Init: Setting up machine state.\n");
-			I_Init ();
+			{
+				FStartupPhase phase("I_Init");
+				I_Init ();
+			}
 		}
 
 		if (!batchrun) Printf ("V_Init: allocate screen.\n");
-		V_Init (!!restart);
+		{
+			FStartupPhase phase("V_Init");
+			V_Init (!!restart);
+		}
 
 		// Base systems have been inited; enable cvar callbacks
 		FBaseCVar::EnableCallbacks ();
 
 		if (!batchrun) Printf ("S_Init: Setting up sound.\n");
-		S_Init ();
+		{
+			FStartupPhase phase("S_Init");
+			S_Init ();
+		}
 
 		if (!batchrun) Printf ("ST_Init: Init startup screen.\n");
 		if (!restart)
@@ -2442,29 +2465,44 @@ void D_DoomMain (void)
 
 		// [RH] Parse any SNDINFO lumps
 		if (!batchrun) Printf ("S_InitData: Load sound definitions.\n");
-		S_InitData ();
+		{
+			FStartupPhase phase("S_InitData");
+			S_InitData ();
+		}
 
 		// [RH] Parse through all loaded mapinfo lumps
 		if (!batchrun) Printf ("G_ParseMapInfo: Load map definitions.\n");
-		G_ParseMapInfo (iwad_info->MapInfo);
+		{
+			FStartupPhase phase("G_ParseMapInfo");
+			G_ParseMapInfo (iwad_info->MapInfo);
+		}
 		ReadStatistics();
 
 		// MUSINFO must be parsed after MAPINFO
 		S_ParseMusInfo();
 
 		if (!batchrun) Printf ("Texman.Init: Init texture manager.\n");
-		TexMan.Init();
+		{
+			FStartupPhase phase("TexMan.Init");
+			TexMan.Init();
+		}
 		C_InitConback();
 
 		StartScreen->Progress();
-		V_InitFonts();
+		{
+			FStartupPhase phase("V_InitFonts");
+			V_InitFonts();
+		}
 
 		// [CW] Parse any TEAMINFO lumps.
 		if (!batchrun) Printf ("ParseTeamInfo: Load team definitions.\n");
 		TeamLibrary.ParseTeamInfo ();
 
 		R_ParseTrnslate();
-		PClassActor::StaticInit ();
+		{
+			FStartupPhase phase("PClassActor::StaticInit");
+			PClassActor::StaticInit ();
+		}
 
 		// [GRB] Initialize player class list
 		SetupPlayerClasses ();
@@ -2480,14 +2518,23 @@ void D_DoomMain (void)
 
 		StartScreen->Progress ();
 
-		ParseGLDefs();
+		{
+			FStartupPhase phase("ParseGLDefs");
+			ParseGLDefs();
+		}
 
 		if (!batchrun) Printf ("R_Init: Init %s refresh subsystem.\n", gameinfo.ConfigName.GetChars());
 		StartScreen->LoadingStatus ("Loading graphics", 0x3f);
-		R_Init ();
+		{
+			FStartupPhase phase("R_Init");
+			R_Init ();
+		}
 
 		if (!batchrun) Printf ("DecalLibrary: Load decals.\n");
-		DecalLibrary.ReadAllDecals ();
+		{
+			FStartupPhase phase("DecalLibrary");
+			DecalLibrary.ReadAllDecals ();
+		}
 
 		// Load embedded Dehacked patches
 		D_LoadDehLumps(FromIWAD);
@@ -2519,7 +2566,10 @@ void D_DoomMain (void)
 		FinishDehPatch();
 
 		if (!batchrun) Printf("M_Init: Init menus.\n");
-		M_Init();
+		{
+			FStartupPhase phase("M_Init");
+			M_Init();
+		}
 
 		// clean up the compiler symbols which are not needed any longer.
 		RemoveUnusedSymbols();
@@ -2541,12 +2591,18 @@ void D_DoomMain (void)
 		if (!batchrun) Printf ("P_Init: Init Playloop state.\n");
 		StartScreen->LoadingStatus ("Init game engine", 0x3f);
 		AM_StaticInit();
-		P_Init ();
+		{
+			FStartupPhase phase("P_Init");
+			P_Init ();
+		}
 
 		P_SetupWeapons_ntohton();
 
 		//SBarInfo support. Note that the first SBARINFO lump contains the mugshot definition so it even needs to be read when a regular status bar is being used.
-		SBarInfo::Load();
+		{
+			FStartupPhase phase("SBarInfo::Load");
+			SBarInfo::Load();
+		}
 
 		if (!batchrun)
 		{
@@ -2609,7 +2665,10 @@ void D_DoomMain (void)
 				throw CNoRunExit();
 			}
 
-			V_Init2();
+			{
+				FStartupPhase phase("V_Init2");
+				V_Init2();
+			}
 			UpdateJoystickMenu(NULL);
 
 			v = Args->CheckValue ("-loadgame");
@@ -0,0 +1,197 @@
+//-----------------------------------------------------------------------------
+//
+// Copyright 2018 GZDoom Development Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+//-----------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//		Startup phase timing
+//
+//-----------------------------------------------------------------------------
+
+#include <chrono>
+#include "doomtype.h"
+#include "tarray.h"
+#include "zstring.h"
+#include "templates.h"
+#include "cmdlib.h"
+#include "m_argv.h"
+#include "files.h"
+#include "version.h"
+#include "d_startuptimer.h"
+
+struct FStartupPhaseTime
+{
+	const char *Name;
+	int Depth;
+	uint64_t Start;
+	uint64_t End;
+};
+
+static TArray<FStartupPhaseTime> Phases;
+static FString ReportFile;
+static bool TimingStartup;
+static int PhaseDepth;
+static uint64_t StartupBegin;
+
+// I_nsTime is not used here because it is affected by i_timescale.
+static uint64_t StartupTimeNS()
+{
+	using namespace std::chrono;
+	return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static double NSToMS(uint64_t ns)
+{
+	return ns * 1e-6;
+}
+
+//==========================================================================
+//
+// FStartupPhase
+//
+// Phases can be nested. Everything that happens between two top level
+// phases shows up in the report as 'Other'.
+//
+//==========================================================================
+
+FStartupPhase::FStartupPhase(const char *name)
+{
+	if (!TimingStartup)
+	{
+		Index = -1;
+		return;
+	}
+	Index = Phases.Push({ name, PhaseDepth, StartupTimeNS(), 0 });
+	PhaseDepth++;
+}
+
+FStartupPhase::~FStartupPhase()
+{
+	// D_FinishStartupTimer may already have closed this phase.
+	if (Index >= 0 && TimingStartup)
+	{
+		Phases[Index].End = StartupTimeNS();
+		PhaseDepth--;
+	}
+}
+
+//==========================================================================
+//
+// D_InitStartupTimer
+//
+// Must be called first thing in D_DoomMain.
+//
+//==========================================================================
+
+void D_InitStartupTimer ()
+{
+	if (!Args->CheckParm("-timestartup"))
+	{
+		return;
+	}
+
+	const char *v = Args->CheckValue("-timestartup");
+	if (v != nullptr)
+	{
+		ReportFile = v;
+		FixPathSeperator(ReportFile);
+	}
+
+	TimingStartup = true;
+	PhaseDepth = 0;
+	Phases.Clear();
+	StartupBegin = StartupTimeNS();
+}
+
+//==========================================================================
+//
+// WriteStartupReport
+//
+//==========================================================================
+
+static bool WriteStartupReport (const char *filename, uint64_t total)
+{
+	FileWriter *f = FileWriter::Open(filename);
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	f->Printf("{\n\t\"engine\": \"%s %s\",\n\t\"git\": \"%s\",\n\t\"units\": \"ms\",\n\t\"total\": %.3f,\n\t\"phases\": [\n",
+		GAMENAME, GetVersionString(), GetGitHash(), NSToMS(total));
+	for (unsigned i = 0; i < Phases.Size(); i++)
+	{
+		auto &p = Phases[i];
+		f->Printf("\t\t{ \"name\": \"%s\", \"depth\": %d, \"start\": %.3f, \"time\": %.3f }%s\n",
+			p.Name, p.Depth, NSToMS(p.Start - StartupBegin), NSToMS(p.End - p.Start), i + 1 < Phases.Size() ? "," : "");
+	}
+	f->Printf("\t]\n}\n");
+	delete f;
+	return true;
+}
+
+//==========================================================================
+//
+// D_FinishStartupTimer
+//
+// Prints the report. This gets called once the first level has been
+// loaded. Any phase that is still running ends here.
+//
+//==========================================================================
+
+void D_FinishStartupTimer ()
+{
+	if (!TimingStartup)
+	{
+		return;
+	}
+	TimingStartup = false;
+
+	uint64_t now = StartupTimeNS();
+	uint64_t total = now - StartupBegin;
+	uint64_t accounted = 0;
+
+	for (auto &p : Phases)
+	{
+		if (p.End == 0) p.End = now;
+		if (p.Depth == 0) accounted += p.End - p.Start;
+	}
+
+	Printf("Startup timing:\n");
+	Printf("%-40s %10s %6s\n", "Phase", "ms", "%");
+	for (auto &p : Phases)
+	{
+		FString name;
+		name.Format("%*s%s", p.Depth * 2, "", p.Name);
+		Printf("%-40s %10.2f %6.1f\n", name.GetChars(), NSToMS(p.End - p.Start), 100. * (p.End - p.Start) / MAX<uint64_t>(total, 1));
+	}
+	Printf("%-40s %10.2f %6.1f\n", "Other", NSToMS(total - accounted), 100. * (total - accounted) / MAX<uint64_t>(total, 1));
+	Printf("%-40s %10.2f\n", "Total", NSToMS(total));
+
+	if (ReportFile.IsNotEmpty())
+	{
+		if (WriteStartupReport(ReportFile, total))
+		{
+			Printf("Startup report written to %s\n", ReportFile.GetChars());
+		}
+		else
+		{
+			Printf("Could not write startup report %s\n", ReportFile.GetChars());
+		}
+	}
+	Phases.Clear();
+}
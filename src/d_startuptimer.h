@@ -0,0 +1,27 @@
+#ifndef __D_STARTUPTIMER_H__
+#define __D_STARTUPTIMER_H__
+
+// Startup phase timing.
+//
+// -timestartup prints how long each of the major init phases took once the
+// first level has been loaded. -timestartup <file> also writes the phases
+// to a JSON file. Combine it with +map or -warp to include a level load in
+// the report, otherwise the title map or first demo is what gets timed.
+
+class FStartupPhase
+{
+public:
+	explicit FStartupPhase(const char *name);
+	~FStartupPhase();
+
+	FStartupPhase(const FStartupPhase&) = delete;
+	FStartupPhase& operator=(const FStartupPhase&) = delete;
+
+private:
+	int Index;
+};
+
+void D_InitStartupTimer ();
+void D_FinishStartupTimer ();
+
+#endif
@@ -73,6 +73,7 @@
 #include "intermission/intermission.h"
 #include "g_levellocals.h"
 #include "events.h"
+#include "stats.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -116,6 +117,8 @@ extern DThinker *NextToThink;
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
 
+cycle_t GCCycles;
+
 namespace GC
 {
 size_t AllocBytes;
@@ -405,6 +408,7 @@ void Step()
 {
 	size_t lim = (GCSTEPSIZE/100) * StepMul;
 	size_t olim;
+	GCCycles.Clock();
 	if (lim == 0)
 	{
 		lim = (~(size_t)0) / 2;		// no limit
@@ -433,6 +437,7 @@ void Step()
 		SetThreshold();
 	}
 	StepCount++;
+	GCCycles.Unclock();
 }
 
 //==========================================================================
@@ -64,7 +64,8 @@
 EXTERN_CVAR(Bool, strictdecorate);
 
 // PUBLIC DATA DEFINITIONS -------------------------------------------------
-FMemArena ClassDataAllocator(32768);	// use this for all static class data that can be released in bulk when the type system is shut down.
+static FMemoryAccount ClassDataMemory("Class data and VM code");
+FMemArena ClassDataAllocator(32768, &ClassDataMemory);	// use this for all static class data that can be released in bulk when the type system is shut down.
 
 TArray<PClass *> PClass::AllClasses;
 TMap<FName, PClass*> PClass::ClassMap;
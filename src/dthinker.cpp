@@ -45,7 +45,8 @@
 
 
 static int ThinkCount;
-static cycle_t ThinkCycles;
+cycle_t ThinkCycles;
+cycle_t SectorEffectCycles;
 extern cycle_t BotSupportCycles;
 extern cycle_t ActionCycles;
 extern int BotWTG;
@@ -57,17 +58,61 @@ struct ProfileInfo
 	int numcalls = 0;
 	cycle_t timer;
 
+	// accumulated since the profile was last reset.
+	int totalcalls = 0;
+	double totaltime = 0;
+
 	ProfileInfo()
 	{
 		timer.Reset();
 	}
 };
 
-static TMap<FName, ProfileInfo> Profiles;
+struct SortedProfileInfo
+{
+	const char* className;
+	int statnum;
+	int numcalls;
+	double time;
+};
+
+// Keyed by class name so that the profile survives a restart.
+static TMap<FName, ProfileInfo> Profiles[MAX_STATNUM + 1];
 static unsigned int profilethinkers, profilelimit;
+static bool ThinkerStatActive();
+
+CVAR(Bool, thinkerprofile, false, 0)
+
 FThinkerCollection Thinkers;
 DThinker *NextToThink;
 
+//==========================================================================
+//
+// The thinkers of one class and its subclasses, split by the list they
+// are in. Each list's entries are sorted by their link sequence, which is
+// the same order the thinker list has. Removed thinkers leave a null entry
+// behind until enough of them have piled up so that iterators can keep
+// their position.
+//
+//==========================================================================
+
+struct FThinkerClassIndex
+{
+	struct Entry
+	{
+		uint64_t Seq;
+		DThinker *Thinker;
+	};
+
+	struct List
+	{
+		TArray<Entry> Entries;
+		unsigned Dead = 0;
+	};
+
+	List Lists[FThinkerCollection::NUM_LISTS];
+};
+
 //==========================================================================
 //
 //
@@ -88,6 +133,66 @@ void FThinkerCollection::Link(DThinker *thinker, int statnum)
 	list->AddTail(thinker);
 }
 
+//==========================================================================
+//
+// Collects the profiled thinker classes, sorted by the given mode.
+// The modes are the same as the ones used by the profilethinkers CCMD.
+//
+//==========================================================================
+
+static void SortProfiles(TArray<SortedProfileInfo> &sorted, unsigned mode, bool totals)
+{
+	sorted.Clear();
+	for (int statnum = 0; statnum <= MAX_STATNUM; statnum++)
+	{
+		TMap<FName, ProfileInfo>::Iterator it(Profiles[statnum]);
+		TMap<FName, ProfileInfo>::Pair *pair;
+		while (it.NextPair(pair))
+		{
+			int numcalls = totals ? pair->Value.totalcalls : pair->Value.numcalls;
+			if (numcalls > 0)
+			{
+				sorted.Push({ pair->Key.GetChars(), statnum, numcalls, totals ? pair->Value.totaltime : pair->Value.timer.TimeMS() });
+			}
+		}
+	}
+
+	std::sort(sorted.begin(), sorted.end(), [=](const SortedProfileInfo& left, const SortedProfileInfo& right)
+	{
+		switch (mode)
+		{
+		case 1: // by name, from A to Z
+			return stricmp(left.className, right.className) < 0;
+		case 2: // by name, from Z to A
+			return stricmp(right.className, left.className) < 0;
+		case 3: // number of calls, ascending
+			return left.numcalls < right.numcalls;
+		case 4: // number of calls, descending
+			return right.numcalls < left.numcalls;
+		case 5: // average time, ascending
+			return left.time / left.numcalls < right.time / right.numcalls;
+		case 6: // average time, descending
+			return right.time / right.numcalls < left.time / left.numcalls;
+		case 7: // total time, ascending
+			return left.time < right.time;
+		default: // total time, descending
+			return right.time < left.time;
+		}
+	});
+}
+
+//==========================================================================
+//
+// Sector effects are clocked separately so that the benchmark can tell
+// them apart from actors.
+//
+//==========================================================================
+
+static inline bool IsSectorEffectStat(int statnum)
+{
+	return statnum == STAT_SECTOREFFECT || statnum == STAT_LIGHT || statnum == STAT_LIGHTTRANSFER || statnum == STAT_SCROLLER;
+}
+
 //==========================================================================
 //
 //
@@ -96,22 +201,27 @@ void FThinkerCollection::Link(DThinker *thinker, int statnum)
 
 void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 {
+	FTraceScope trace("RunThinkers");
 	int i, count;
 
 	ThinkCount = 0;
 	ThinkCycles.Reset();
+	SectorEffectCycles.Reset();
 	BotSupportCycles.Reset();
 	ActionCycles.Reset();
 	BotWTG = 0;
 
 	ThinkCycles.Clock();
 
-	if (!profilethinkers)
+	if (!profilethinkers && !thinkerprofile && !ThinkerStatActive())
 	{
 		// Tick every thinker left from last time
 		for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 		{
+			bool effect = IsSectorEffectStat(i);
+			if (effect) SectorEffectCycles.Clock();
 			Thinkers[i].TickThinkers(nullptr);
+			if (effect) SectorEffectCycles.Unclock();
 		}
 
 		// Keep ticking the fresh thinkers until there are no new ones.
@@ -120,7 +230,10 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 			count = 0;
 			for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 			{
+				bool effect = IsSectorEffectStat(i);
+				if (effect) SectorEffectCycles.Clock();
 				count += FreshThinkers[i].TickThinkers(&Thinkers[i]);
+				if (effect) SectorEffectCycles.Unclock();
 			}
 		} while (count != 0);
 
@@ -133,11 +246,24 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 	}
 	else
 	{
-		Profiles.Clear();
+		for (auto &list : Profiles)
+		{
+			TMap<FName, ProfileInfo>::Iterator it(list);
+			TMap<FName, ProfileInfo>::Pair *pair;
+			while (it.NextPair(pair))
+			{
+				pair->Value.numcalls = 0;
+				pair->Value.timer.Reset();
+			}
+		}
+
 		// Tick every thinker left from last time
 		for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 		{
-			Thinkers[i].ProfileThinkers(nullptr);
+			bool effect = IsSectorEffectStat(i);
+			if (effect) SectorEffectCycles.Clock();
+			Thinkers[i].ProfileThinkers(nullptr, i);
+			if (effect) SectorEffectCycles.Unclock();
 		}
 
 		// Keep ticking the fresh thinkers until there are no new ones.
@@ -146,12 +272,15 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 			count = 0;
 			for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 			{
-				count += FreshThinkers[i].ProfileThinkers(&Thinkers[i]);
+				bool effect = IsSectorEffectStat(i);
+				if (effect) SectorEffectCycles.Clock();
+				count += FreshThinkers[i].ProfileThinkers(&Thinkers[i], i);
+				if (effect) SectorEffectCycles.Unclock();
 			}
 		} while (count != 0);
 
 		// Also profile the internal dynamic lights, even though they are not implemented as thinkers.
-		auto &prof = Profiles[NAME_InternalDynamicLight];
+		auto &prof = Profiles[STAT_DLIGHT][NAME_InternalDynamicLight];
 		prof.timer.Clock();
 		for (auto light = Level->lights; light;)
 		{
@@ -162,63 +291,40 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 		}
 		prof.timer.Unclock();
 
+		for (auto &list : Profiles)
+		{
+			TMap<FName, ProfileInfo>::Iterator it(list);
+			TMap<FName, ProfileInfo>::Pair *pair;
+			while (it.NextPair(pair))
+			{
+				pair->Value.totalcalls += pair->Value.numcalls;
+				pair->Value.totaltime += pair->Value.timer.TimeMS();
+			}
+		}
 
-		struct SortedProfileInfo
+		if (profilethinkers)
 		{
-			const char* className;
-			int numcalls;
-			double time;
-		};
+			TArray<SortedProfileInfo> sorted;
+			SortProfiles(sorted, profilethinkers, false);
 
-		TArray<SortedProfileInfo> sorted;
-		sorted.Grow(Profiles.CountUsed());
+			Printf(TEXTCOLOR_YELLOW "Total, ms   Averg, ms   Calls   Stat  Actor class\n");
+			Printf(TEXTCOLOR_YELLOW "----------  ----------  ------  ----  --------------------\n");
 
-		auto it = TMap<FName, ProfileInfo>::Iterator(Profiles);
-		TMap<FName, ProfileInfo>::Pair *pair;
-		while (it.NextPair(pair))
-		{
-			sorted.Push({ pair->Key.GetChars(), pair->Value.numcalls, pair->Value.timer.TimeMS() });
-		}
+			const unsigned count = MIN(profilelimit > 0 ? profilelimit : UINT_MAX, sorted.Size());
 
-		std::sort(sorted.begin(), sorted.end(), [](const SortedProfileInfo& left, const SortedProfileInfo& right)
-		{
-			switch (profilethinkers)
+			for (unsigned i = 0; i < count; ++i)
 			{
-			case 1: // by name, from A to Z
-				return stricmp(left.className, right.className) < 0;
-			case 2: // by name, from Z to A
-				return stricmp(right.className, left.className) < 0;
-			case 3: // number of calls, ascending
-				return left.numcalls < right.numcalls;
-			case 4: // number of calls, descending
-				return right.numcalls < left.numcalls;
-			case 5: // average time, ascending
-				return left.time / left.numcalls < right.time / right.numcalls;
-			case 6: // average time, descending
-				return right.time / right.numcalls < left.time / left.numcalls;
-			case 7: // total time, ascending
-				return left.time < right.time;
-			default: // total time, descending
-				return right.time < left.time;
+				const SortedProfileInfo& info = sorted[i];
+				Printf("%s%10.6f  %s%10.6f  %s%6d  " TEXTCOLOR_WHITE "%4d  %s%s\n",
+					profilethinkers >= 7 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.time,
+					profilethinkers == 5 || profilethinkers == 6 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.time / info.numcalls,
+					profilethinkers == 3 || profilethinkers == 4 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.numcalls,
+					info.statnum,
+					profilethinkers == 1 || profilethinkers == 2 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.className);
 			}
-		});
-
-		Printf(TEXTCOLOR_YELLOW "Total, ms   Averg, ms   Calls   Actor class\n");
-		Printf(TEXTCOLOR_YELLOW "----------  ----------  ------  --------------------\n");
 
-		const unsigned count = MIN(profilelimit > 0 ? profilelimit : UINT_MAX, sorted.Size());
-
-		for (unsigned i = 0; i < count; ++i)
-		{
-			const SortedProfileInfo& info = sorted[i];
-			Printf("%s%10.6f  %s%10.6f  %s%6d  %s%s\n",
-				profilethinkers >= 7 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.time,
-				profilethinkers == 5 || profilethinkers == 6 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.time / info.numcalls,
-				profilethinkers == 3 || profilethinkers == 4 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.numcalls,
-				profilethinkers == 1 || profilethinkers == 2 ? TEXTCOLOR_YELLOW : TEXTCOLOR_WHITE, info.className);
+			profilethinkers = 0;
 		}
-
-		profilethinkers = 0;
 	}
 
 	ThinkCycles.Unclock();
@@ -244,6 +350,9 @@ void FThinkerCollection::DestroyAllThinkers()
 		}
 	}
 	error |= Thinkers[MAX_STATNUM + 1].DoDestroyThinkers();
+	// The indices get rebuilt on demand. This also gets rid of them before
+	// the classes go away when restarting.
+	ClearClassIndices();
 	GC::FullGC();
 	if (error)
 	{
@@ -329,6 +438,189 @@ void FThinkerCollection::SerializeThinkers(FSerializer &arc, bool hubLoad)
 }
 
 
+//==========================================================================
+//
+// FThinkerCollection :: ListNumber
+//
+//==========================================================================
+
+int FThinkerCollection::ListNumber(const FThinkerList *list) const
+{
+	if (list >= Thinkers && list < Thinkers + countof(Thinkers))
+	{
+		return int(list - Thinkers);
+	}
+	assert(list >= FreshThinkers && list < FreshThinkers + countof(FreshThinkers));
+	return FIRST_FRESH_LIST + int(list - FreshThinkers);
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: GetClassIndex
+//
+// Returns the index for the given class, creating it if necessary.
+// There is no index for the base classes because almost everything
+// would be in it.
+//
+//==========================================================================
+
+FThinkerClassIndex *FThinkerCollection::GetClassIndex(const PClass *type)
+{
+	if (type == RUNTIME_CLASS(DThinker) || type == RUNTIME_CLASS(AActor) || !type->IsDescendantOf(RUNTIME_CLASS(DThinker)))
+	{
+		return nullptr;
+	}
+
+	auto check = ClassIndices.CheckKey(type);
+	if (check != nullptr)
+	{
+		return *check;
+	}
+
+	auto index = new FThinkerClassIndex;
+	for (int i = 0; i < NUM_LISTS; i++)
+	{
+		const FThinkerList &list = i < FIRST_FRESH_LIST ? Thinkers[i] : FreshThinkers[i - FIRST_FRESH_LIST];
+		DThinker *node = list.GetHead();
+		if (node == nullptr) continue;
+
+		for (; !(node->ObjectFlags & OF_Sentinel); node = node->NextThinker)
+		{
+			if (node->IsKindOf(type))
+			{
+				index->Lists[i].Entries.Push({ node->LinkSeq, node });
+			}
+		}
+	}
+	ClassIndices[type] = index;
+	IndicesForClass.Clear();
+	return index;
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: GetIndicesFor
+//
+// Returns all indices a thinker of the given class needs to be in.
+//
+//==========================================================================
+
+TArray<FThinkerClassIndex *> &FThinkerCollection::GetIndicesFor(const PClass *type)
+{
+	auto check = IndicesForClass.CheckKey(type);
+	if (check != nullptr)
+	{
+		return *check;
+	}
+
+	auto &indices = IndicesForClass[type];
+	for (auto cls = type; cls != nullptr; cls = cls->ParentClass)
+	{
+		auto index = ClassIndices.CheckKey(cls);
+		if (index != nullptr) indices.Push(*index);
+	}
+	return indices;
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: IndexThinker
+//
+// Called whenever a thinker gets linked into a list.
+//
+//==========================================================================
+
+void FThinkerCollection::IndexThinker(DThinker *thinker, const FThinkerList *list)
+{
+	thinker->LinkSeq = ++LinkCounter;
+	thinker->LinkList = ListNumber(list);
+
+	if (ClassIndices.CountUsed() == 0)
+	{
+		return;
+	}
+	for (auto index : GetIndicesFor(thinker->GetClass()))
+	{
+		index->Lists[thinker->LinkList].Entries.Push({ thinker->LinkSeq, thinker });
+	}
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: UnindexThinker
+//
+//==========================================================================
+
+void FThinkerCollection::UnindexThinker(DThinker *thinker)
+{
+	if (ClassIndices.CountUsed() == 0)
+	{
+		return;
+	}
+	for (auto index : GetIndicesFor(thinker->GetClass()))
+	{
+		auto &list = index->Lists[thinker->LinkList];
+		auto &entries = list.Entries;
+		auto entry = std::lower_bound(entries.begin(), entries.end(), thinker->LinkSeq,
+			[](const FThinkerClassIndex::Entry &e, uint64_t seq) { return e.Seq < seq; });
+
+		if (entry == entries.end() || entry->Thinker != thinker)
+		{
+			continue;
+		}
+		entry->Thinker = nullptr;
+
+		if (++list.Dead > 16 && list.Dead > entries.Size() / 2)
+		{
+			unsigned j = 0;
+			for (unsigned i = 0; i < entries.Size(); i++)
+			{
+				if (entries[i].Thinker != nullptr) entries[j++] = entries[i];
+			}
+			entries.Resize(j);
+			list.Dead = 0;
+		}
+	}
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: UnindexList
+//
+// For lists that are taken down without unlinking every thinker.
+//
+//==========================================================================
+
+void FThinkerCollection::UnindexList(const FThinkerList *list)
+{
+	int num = ListNumber(list);
+	TMap<const PClass *, FThinkerClassIndex *>::Iterator it(ClassIndices);
+	TMap<const PClass *, FThinkerClassIndex *>::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		pair->Value->Lists[num].Entries.Clear();
+		pair->Value->Lists[num].Dead = 0;
+	}
+}
+
+//==========================================================================
+//
+// FThinkerCollection :: ClearClassIndices
+//
+//==========================================================================
+
+void FThinkerCollection::ClearClassIndices()
+{
+	TMap<const PClass *, FThinkerClassIndex *>::Iterator it(ClassIndices);
+	TMap<const PClass *, FThinkerClassIndex *>::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		delete pair->Value;
+	}
+	ClassIndices.Clear();
+	IndicesForClass.Clear();
+}
+
 //==========================================================================
 //
 //
@@ -358,6 +650,7 @@ void FThinkerList::AddTail(DThinker *thinker)
 	GC::WriteBarrier(thinker, Sentinel);
 	GC::WriteBarrier(tail, thinker);
 	GC::WriteBarrier(Sentinel, thinker);
+	::Thinkers.IndexThinker(thinker, this);
 }
 
 //==========================================================================
@@ -482,6 +775,7 @@ bool FThinkerList::DoDestroyThinkers()
 			node = next;
 		}
 		Sentinel->NextThinker = Sentinel->PrevThinker = nullptr;
+		::Thinkers.UnindexList(this);
 		Sentinel->Destroy();
 		Sentinel = nullptr;
 		for (auto node : toDelete)
@@ -586,7 +880,7 @@ int FThinkerList::TickThinkers(FThinkerList *dest)
 //
 //
 //==========================================================================
-int FThinkerList::ProfileThinkers(FThinkerList *dest)
+int FThinkerList::ProfileThinkers(FThinkerList *dest, int statnum)
 {
 	int count = 0;
 	DThinker *node = GetHead();
@@ -619,7 +913,7 @@ int FThinkerList::ProfileThinkers(FThinkerList *dest)
 		{ // Only tick thinkers not scheduled for destruction
 			ThinkCount++;
 
-			auto &prof = Profiles[node->GetClass()->TypeName];
+			auto &prof = Profiles[statnum][node->GetClass()->TypeName];
 			prof.numcalls++;
 			prof.timer.Clock();
 			node->CallTick();
@@ -648,6 +942,8 @@ DThinker::DThinker(FLevelLocals *l) throw()
 {
 	NextThinker = nullptr;
 	PrevThinker = nullptr;
+	LinkSeq = 0;
+	LinkList = -1;
 	Level = l;
 	ObjectFlags |= OF_JustSpawned;
 }
@@ -693,6 +989,7 @@ void DThinker::Remove()
 	GC::WriteBarrier(next, prev);
 	NextThinker = nullptr;
 	PrevThinker = nullptr;
+	Thinkers.UnindexThinker(this);
 }
 
 //==========================================================================
@@ -892,6 +1189,9 @@ FThinkerIterator::FThinkerIterator (FLevelLocals *Level, const PClass *type, int
 	m_ParentType = type;
 	m_CurrThinker = Thinkers.Thinkers[m_Stat].GetHead();
 	m_SearchingFresh = false;
+	m_UseIndex = type != nullptr && Thinkers.GetClassIndex(type) != nullptr;
+	m_IndexPos = 0;
+	m_IndexSeq = 0;
 }
 
 //==========================================================================
@@ -934,6 +1234,8 @@ void FThinkerIterator::Reinit ()
 {
 	m_CurrThinker = Thinkers.Thinkers[m_Stat].GetHead();
 	m_SearchingFresh = false;
+	m_IndexPos = 0;
+	m_IndexSeq = 0;
 }
 
 //==========================================================================
@@ -948,6 +1250,10 @@ DThinker *FThinkerIterator::Next (bool exact)
 	{
 		return nullptr;
 	}
+	if (m_UseIndex)
+	{
+		return NextIndexed(Thinkers.GetClassIndex(m_ParentType), exact);
+	}
 	do
 	{
 		do
@@ -990,6 +1296,55 @@ DThinker *FThinkerIterator::Next (bool exact)
 	return nullptr;
 }
 
+//==========================================================================
+//
+// FThinkerIterator :: NextIndexed
+//
+// Same as Next but only looks at the thinkers in the class index. The
+// lists are searched in the same order and the index stores the thinkers
+// in list order, so this returns the same thinkers as walking the lists.
+//
+//==========================================================================
+
+DThinker *FThinkerIterator::NextIndexed (FThinkerClassIndex *index, bool exact)
+{
+	do
+	{
+		do
+		{
+			int num = m_SearchingFresh ? FThinkerCollection::FIRST_FRESH_LIST + m_Stat : m_Stat;
+			auto &entries = index->Lists[num].Entries;
+
+			// The list may have been compacted since the last call.
+			if (m_IndexPos > 0 && (m_IndexPos > entries.Size() || entries[m_IndexPos - 1].Seq != m_IndexSeq))
+			{
+				m_IndexPos = unsigned(std::upper_bound(entries.begin(), entries.end(), m_IndexSeq,
+					[](uint64_t seq, const FThinkerClassIndex::Entry &e) { return seq < e.Seq; }) - entries.begin());
+			}
+			while (m_IndexPos < entries.Size())
+			{
+				auto &entry = entries[m_IndexPos++];
+				m_IndexSeq = entry.Seq;
+				if (entry.Thinker != nullptr && (!exact || entry.Thinker->IsA(m_ParentType)))
+				{
+					return entry.Thinker;
+				}
+			}
+			m_IndexPos = 0;
+			m_IndexSeq = 0;
+		} while ((m_SearchingFresh = !m_SearchingFresh));
+		if (m_SearchStats)
+		{
+			m_Stat++;
+			if (m_Stat > MAX_STATNUM)
+			{
+				m_Stat = STAT_FIRST_THINKING;
+			}
+		}
+	} while (m_SearchStats && m_Stat != STAT_FIRST_THINKING);
+	return nullptr;
+}
+
 //==========================================================================
 //
 //
@@ -1002,3 +1357,85 @@ ADD_STAT (think)
 	out.Format ("Think time = %04.2f ms - %d thinkers, Action = %04.2f ms", ThinkCycles.TimeMS(), ThinkCount, ActionCycles.TimeMS());
 	return out;
 }
+
+//==========================================================================
+//
+// Per class thinker profile. While this is displayed or thinkerprofile
+// is set, the thinkers are ticked through the profiling path.
+//
+//==========================================================================
+
+ADD_STAT (thinkers)
+{
+	FString out;
+	TArray<SortedProfileInfo> sorted;
+	SortProfiles(sorted, 8, false);
+	if (sorted.Size() == 0)
+	{
+		return "No thinkers profiled yet";
+	}
+
+	out.Format("Total, ms   Calls   Stat  Class\n");
+	const unsigned count = MIN(10u, sorted.Size());
+	for (unsigned i = 0; i < count; ++i)
+	{
+		const SortedProfileInfo& info = sorted[i];
+		out.AppendFormat("%10.4f  %6d  %4d  %s\n", info.time, info.numcalls, info.statnum, info.className);
+	}
+	return out;
+}
+
+static bool ThinkerStatActive()
+{
+	return Istaticstatthinkers.isActive();
+}
+
+//==========================================================================
+//
+// Writes the accumulated per class profile to a file
+//
+//==========================================================================
+
+CCMD(dumpthinkerprofile)
+{
+	if (argv.argc() < 2)
+	{
+		Printf("Usage: dumpthinkerprofile <filename> [limit]\n");
+		return;
+	}
+
+	TArray<SortedProfileInfo> sorted;
+	SortProfiles(sorted, 8, true);
+	if (sorted.Size() == 0)
+	{
+		Printf("No thinkers have been profiled. Set thinkerprofile to true or use 'stat thinkers' first.\n");
+		return;
+	}
+
+	FileWriter *f = FileWriter::Open(argv[1]);
+	if (f == nullptr)
+	{
+		Printf("Unable to open %s\n", argv[1]);
+		return;
+	}
+
+	unsigned limit = argv.argc() > 2 ? (unsigned)atoi(argv[2]) : 0;
+	const unsigned count = MIN(limit > 0 ? limit : UINT_MAX, sorted.Size());
+
+	f->Printf("Total, ms     Averg, ms   Calls       Stat  Class\n");
+	for (unsigned i = 0; i < count; ++i)
+	{
+		const SortedProfileInfo& info = sorted[i];
+		f->Printf("%12.4f  %10.6f  %10d  %4d  %s\n", info.time, info.time / info.numcalls, info.numcalls, info.statnum, info.className);
+	}
+	delete f;
+	Printf("Thinker profile written to %s\n", argv[1]);
+}
+
+CCMD(resetthinkerprofile)
+{
+	for (auto &list : Profiles)
+	{
+		list.Clear();
+	}
+}
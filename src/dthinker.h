@@ -47,6 +47,7 @@ class FSerializer;
 struct FLevelLocals;
 
 class FThinkerIterator;
+struct FThinkerClassIndex;
 
 enum { MAX_STATNUM = 127 };
 
@@ -61,7 +62,7 @@ struct FThinkerList
 	void DestroyThinkers();
 	bool DoDestroyThinkers();
 	int TickThinkers(FThinkerList *dest);	// Returns: # of thinkers ticked
-	int ProfileThinkers(FThinkerList *dest);
+	int ProfileThinkers(FThinkerList *dest, int statnum);
 	void SaveList(FSerializer &arc);
 
 private:
@@ -85,10 +86,33 @@ struct FThinkerCollection
 	DThinker *FirstThinker(int statnum);
 	void Link(DThinker *thinker, int statnum);
 
+	// Every FThinkerList in the collection gets a number for the class indices.
+	enum
+	{
+		FIRST_FRESH_LIST = MAX_STATNUM + 2,
+		NUM_LISTS = FIRST_FRESH_LIST + MAX_STATNUM + 1
+	};
+
 private:
 	FThinkerList Thinkers[MAX_STATNUM + 2];
 	FThinkerList FreshThinkers[MAX_STATNUM + 1];
 
+	// Thinker iterators that look for a specific class use an index of all
+	// thinkers of that class and its subclasses that gets created on first use.
+	TMap<const PClass *, FThinkerClassIndex *> ClassIndices;
+	TMap<const PClass *, TArray<FThinkerClassIndex *>> IndicesForClass;
+	uint64_t LinkCounter = 0;
+
+	int ListNumber(const FThinkerList *list) const;
+	FThinkerClassIndex *GetClassIndex(const PClass *type);
+	TArray<FThinkerClassIndex *> &GetIndicesFor(const PClass *type);
+	void IndexThinker(DThinker *thinker, const FThinkerList *list);
+	void UnindexThinker(DThinker *thinker);
+	void UnindexList(const FThinkerList *list);
+	void ClearClassIndices();
+
+	friend struct FThinkerList;
+	friend class DThinker;
 	friend class FThinkerIterator;
 };
 
@@ -136,6 +160,10 @@ private:
 	friend class FSerializer;
 
 	DThinker *NextThinker, *PrevThinker;
+
+	// Order and list number of the last link into a thinker list, for the class indices.
+	uint64_t LinkSeq;
+	int LinkList;
 };
 
 class FThinkerIterator
@@ -149,6 +177,15 @@ private:
 	bool m_SearchingFresh;
 	FLevelLocals *Level;
 
+	// Set when the class index can be used instead of the thinker lists.
+	// The index itself is looked up on each call because it gets deleted
+	// along with the level's thinkers.
+	bool m_UseIndex = false;
+	unsigned m_IndexPos;
+	uint64_t m_IndexSeq;
+
+	DThinker *NextIndexed(FThinkerClassIndex *index, bool exact);
+
 public:
 	FThinkerIterator (FLevelLocals *Level, const PClass *type, int statnum=MAX_STATNUM+1);
 	FThinkerIterator (FLevelLocals *Level, const PClass *type, int statnum, DThinker *prev);
@@ -3645,26 +3645,23 @@ void FParser::SF_ThingCount(void)
 		pClass = pClass->GetReplacement();
 		
 again:
-		TThinkerIterator<AActor> it(Level);
+		TThinkerIterator<AActor> it(Level, pClass);
 
 		if (t_argc<2 || intvalue(t_argv[1])==0 || pClass->IsDescendantOf(NAME_Inventory))
 		{
-			while ((mo=it.Next()))
+			while ((mo=it.Next(true)))
 			{
-				if (mo->IsA(pClass))
+				if (mo->IsMapActor())
 				{
-					if (mo->IsMapActor())
-					{
-						count++;
-					}
+					count++;
 				}
 			}
 		}
 		else
 		{
-			while ((mo=it.Next()))
+			while ((mo=it.Next(true)))
 			{
-				if (mo->IsA(pClass) && mo->health>0) count++;
+				if (mo->health>0) count++;
 			}
 		}
 		if (!replacemented)
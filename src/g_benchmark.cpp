@@ -0,0 +1,218 @@
+//-----------------------------------------------------------------------------
+//
+// Copyright 2018 GZDoom Development Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+//-----------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//		Playsim benchmark with per-tic reports
+//
+//-----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include "doomstat.h"
+#include "templates.h"
+#include "cmdlib.h"
+#include "c_console.h"
+#include "m_argv.h"
+#include "m_random.h"
+#include "files.h"
+#include "stats.h"
+#include "version.h"
+#include "g_benchmark.h"
+
+extern cycle_t TickerCycles, ThinkCycles, SectorEffectCycles, SightCycles, ACSTime, GCCycles;
+extern cycle_t VMCycles[10];
+
+bool benchmarking;
+
+struct FBenchmarkSample
+{
+	int Tic;
+	double Ticker;
+	double Think;
+	double SectorEffects;
+	double Sight;
+	double VM;
+	double ACS;
+	double GC;
+};
+
+static TArray<FBenchmarkSample> Samples;
+static FString ReportFile;
+static int BenchTics;
+
+// The VM and GC clocks are never reset by the playsim so these are
+// used to get the time spent during a single tic.
+static double LastVMTime, LastGCTime;
+
+//==========================================================================
+//
+// BM_Init
+//
+// Checks the command line for -benchmark. Benchmarks always run one tic
+// per frame without drawing or sound so that the results only depend on
+// the playsim. The video mode still gets set up; see g_benchmark.h.
+//
+//==========================================================================
+
+void BM_Init ()
+{
+	const char *v = Args->CheckValue("-benchmark");
+	if (v == nullptr)
+	{
+		return;
+	}
+
+	benchmarking = true;
+	ReportFile = v;
+	FixPathSeperator(ReportFile);
+
+	v = Args->CheckValue("-benchtics");
+	BenchTics = v != nullptr ? MAX(0, atoi(v)) : 0;
+
+	nodrawers = true;
+	singletics = true;
+
+	// Runs without a demo must be reproducible.
+	if (!use_staticrng)
+	{
+		rngseed = staticrngseed = 0;
+		use_staticrng = true;
+	}
+
+	Samples.Clear();
+	LastVMTime = VMCycles[0].TimeMS();
+	LastGCTime = GCCycles.TimeMS();
+}
+
+//==========================================================================
+//
+// BM_Tic
+//
+// Records the clocks of the tic that just ran. Must be called after
+// the tic's garbage collection step.
+//
+//==========================================================================
+
+void BM_Tic ()
+{
+	if (!benchmarking || gamestate != GS_LEVEL)
+	{
+		return;
+	}
+
+	double vmtime = VMCycles[0].TimeMS();
+	double gctime = GCCycles.TimeMS();
+
+	FBenchmarkSample sample;
+	sample.Tic = Samples.Size();
+	sample.Ticker = TickerCycles.TimeMS();
+	sample.Think = ThinkCycles.TimeMS();
+	sample.SectorEffects = SectorEffectCycles.TimeMS();
+	sample.Sight = SightCycles.TimeMS();
+	// The VM clock gets reset when its stat is being displayed.
+	sample.VM = vmtime >= LastVMTime ? vmtime - LastVMTime : vmtime;
+	sample.ACS = ACSTime.TimeMS();
+	sample.GC = gctime - LastGCTime;
+	Samples.Push(sample);
+
+	LastVMTime = vmtime;
+	LastGCTime = gctime;
+
+	if (BenchTics > 0 && (int)Samples.Size() >= BenchTics)
+	{
+		BM_Finish();
+	}
+}
+
+//==========================================================================
+//
+// BM_WriteReport
+//
+//==========================================================================
+
+static bool BM_WriteReport (const char *filename)
+{
+	FileWriter *f = FileWriter::Open(filename);
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	FString name = filename;
+	bool csv = name.Len() > 4 && !stricmp(name.Right(4), ".csv");
+
+	if (csv)
+	{
+		f->Printf("tic,ticker,think,sectoreffects,sight,vm,acs,gc\n");
+		for (auto &s : Samples)
+		{
+			f->Printf("%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+				s.Tic, s.Ticker, s.Think, s.SectorEffects, s.Sight, s.VM, s.ACS, s.GC);
+		}
+	}
+	else
+	{
+		f->Printf("{\n\t\"engine\": \"%s %s\",\n\t\"git\": \"%s\",\n\t\"rngseed\": %u,\n\t\"units\": \"ms\",\n\t\"tics\": [\n",
+			GAMENAME, GetVersionString(), GetGitHash(), rngseed);
+		for (unsigned i = 0; i < Samples.Size(); i++)
+		{
+			auto &s = Samples[i];
+			f->Printf("\t\t{ \"tic\": %d, \"ticker\": %.4f, \"think\": %.4f, \"sectoreffects\": %.4f, \"sight\": %.4f, \"vm\": %.4f, \"acs\": %.4f, \"gc\": %.4f }%s\n",
+				s.Tic, s.Ticker, s.Think, s.SectorEffects, s.Sight, s.VM, s.ACS, s.GC, i + 1 < Samples.Size() ? "," : "");
+		}
+		f->Printf("\t]\n}\n");
+	}
+	delete f;
+	return true;
+}
+
+//==========================================================================
+//
+// BM_Finish
+//
+// Writes the report and quits. This gets called when the demo being
+// timed ends or after the requested number of tics.
+//
+//==========================================================================
+
+void BM_Finish ()
+{
+	if (!benchmarking)
+	{
+		return;
+	}
+	benchmarking = false;
+
+	double total = 0, peak = 0;
+	for (auto &s : Samples)
+	{
+		total += s.Ticker;
+		peak = MAX(peak, s.Ticker);
+	}
+
+	Printf("Benchmark: %u tics, P_Ticker average %.3f ms, peak %.3f ms\n",
+		Samples.Size(), Samples.Size() > 0 ? total / Samples.Size() : 0., peak);
+
+	if (!BM_WriteReport(ReportFile))
+	{
+		Printf("Could not write benchmark report %s\n", ReportFile.GetChars());
+		exit(1);
+	}
+	Printf("Benchmark report written to %s\n", ReportFile.GetChars());
+	exit(0);
+}
@@ -0,0 +1,24 @@
+#ifndef __G_BENCHMARK_H__
+#define __G_BENCHMARK_H__
+
+// Playsim benchmark.
+//
+// -benchmark <file> records the time spent in the major playsim phases
+// for every game tic and writes it out as CSV (if the file name ends in
+// .csv) or JSON when the run ends. It can be combined with -timedemo to
+// profile a demo or with +map/-warp and -benchtics <n> to run a map for
+// a fixed number of tics without any player input.
+//
+// This is not headless. Drawing is disabled, but the window and the video
+// backend are still created and a GPU is required, because map loading
+// builds the hardware renderer's vertex buffers and the status bar, view
+// window and console all size themselves from the framebuffer. Running
+// without a window would need a null video backend, which does not exist.
+
+extern bool benchmarking;
+
+void BM_Init ();
+void BM_Tic ();
+void BM_Finish ();
+
+#endif
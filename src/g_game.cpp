@@ -75,6 +75,7 @@
 
 #include "g_levellocals.h"
 #include "events.h"
+#include "g_benchmark.h"
 
 
 static FRandom pr_dmspawn ("DMSpawn");
@@ -534,6 +535,12 @@ void G_BuildTiccmd (ticcmd_t *cmd)
 
 	cmd->consistancy = consistancy[consoleplayer][(maketic/ticdup)%BACKUPTICS];
 
+	// Benchmarks that run without a demo must not depend on the input devices.
+	if (benchmarking)
+	{
+		return;
+	}
+
 	strafe = Button_Strafe.bDown;
 	speed = Button_Speed.bDown ^ (int)cl_run;
 
@@ -2728,7 +2735,7 @@ void G_DoPlayDemo (void)
 //
 void G_TimeDemo (const char* name)
 {
-	nodrawers = !!Args->CheckParm ("-nodraw");
+	nodrawers = !!Args->CheckParm ("-nodraw") || benchmarking;
 	noblit = !!Args->CheckParm ("-noblit");
 	timingdemo = true;
 	singletics = true;
@@ -2782,6 +2789,9 @@ bool G_CheckDemoStatus (void)
 		}
 		if (singledemo || timingdemo)
 		{
+			// Quits after writing its report.
+			BM_Finish ();
+
 			if (timingdemo)
 			{
 				// Trying to get back to a stable state after timing a demo
@@ -89,6 +89,7 @@
 #include "i_time.h"
 #include "p_maputl.h"
 #include "hwrenderer/dynlights/hw_shadowmap.h"
+#include "d_startuptimer.h"
 
 // Compatibility glue to emulate removed features.
 FLevelLocals emptyLevelPlaceholderForZScript;
@@ -1008,6 +1009,7 @@ extern gamestate_t 	wipegamestate;
  
 void G_DoLoadLevel (const FString &nextlevel, int position, bool autosave, bool newGame)
 {
+	FStartupPhase phase("G_DoLoadLevel");
 	auto levelinfo = FindLevelInfo(nextlevel);
 	TArray<level_info_t *> MapSet;
 
@@ -1200,6 +1202,9 @@ void G_DoLoadLevel (const FString &nextlevel, int position, bool autosave, bool
 	{
 		I_Error("no start for player %d found.", pnumerr);
 	}
+
+	// The first level load is the last step of startup.
+	D_FinishStartupTimer();
 }
 
 
@@ -249,6 +249,7 @@ enum ELevelFlags : unsigned int
 	LEVEL3_EXITNORMALUSED		= 0x00000020,
 	LEVEL3_EXITSECRETUSED		= 0x00000040,
 	LEVEL3_FORCEWORLDPANNING	= 0x00000080,	// Forces the world panning flag for all textures, even those without it explicitly set.
+	LEVEL3_ACTORLOD				= 0x00000100,	// idle monsters far away from all players tick at a reduced rate
 };
 
 
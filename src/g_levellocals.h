@@ -65,6 +65,69 @@ typedef TMap<int, int> FDialogueIDMap;				// maps dialogue IDs to dialogue array
 typedef TMap<FName, int> FDialogueMap;				// maps actor class names to dialogue array index
 typedef TMap<int, FUDMFKeys> FUDMFKeyMap;
 
+// All actors with the same TID, oldest first. Removed actors leave a null
+// entry behind until enough of them have piled up. The sequence numbers
+// only ever grow so iterators can find their place after a compaction.
+struct FTIDBucket
+{
+	struct Entry
+	{
+		AActor *Actor;
+		uint64_t Seq;
+	};
+	TArray<Entry> Actors;
+	unsigned Dead = 0;
+};
+
+struct FTIDHashTraits
+{
+	// TIDs are often given out in strides so the bits need to be mixed.
+	hash_t Hash(int key)
+	{
+		uint32_t h = key;
+		h ^= h >> 16;
+		h *= 0x85ebca6b;
+		h ^= h >> 13;
+		h *= 0xc2b2ae35;
+		h ^= h >> 16;
+		return h;
+	}
+	int Compare(int left, int right) { return left != right; }
+};
+
+typedef TMap<int, FTIDBucket, FTIDHashTraits> FTIDHash;
+
+// Sector adjacency for P_NoiseAlert. Whether a line is closed for sound
+// only gets recalculated after the planes on either side have moved.
+struct FSoundEdge
+{
+	line_t *line;
+	sector_t *other;		// null for one-sided portal lines
+	unsigned PlaneChanges;	// sum of both sectors' PlaneChanges when Closed was set
+	bool Closed;
+};
+
+struct FSoundSector
+{
+	secplane_t floorplane, ceilingplane;	// as of the last change
+	unsigned PlaneChanges;
+	unsigned CheckedAlert;
+	unsigned FirstEdge, NumEdges;
+};
+
+struct FSoundGraph
+{
+	TArray<FSoundSector> Sectors;
+	TArray<FSoundEdge> Edges;
+	unsigned Alert;
+
+	void Clear()
+	{
+		Sectors.Clear();
+		Edges.Clear();
+	}
+};
+
 struct FLevelData
 {
 	TArray<vertex_t> vertexes;
@@ -81,6 +144,8 @@ struct FLevelData
 	TArray<node_t> gamenodes;
 	node_t *headgamenode;
 	TArray<uint8_t> rejectmatrix;
+	TArray<uint8_t> sightpvs;	// generated when there is no REJECT, a set bit means the sectors may see each other
+	FSoundGraph SoundGraph;		// built on first use
 	TArray<zone_t>	Zones;
 	TArray<FPolyObj> Polyobjects;
 
@@ -171,11 +236,12 @@ struct FLevelLocals : public FLevelData
 
 	void ClearTIDHashes ()
 	{
-		memset(TIDHash, 0, sizeof(TIDHash));
+		TIDHash.Clear();
 	}
 
 	FTagManager tagManager;
-	AActor *TIDHash[128];
+	FTIDHash TIDHash;
+	uint64_t TIDSeq = 0;
 
 	DSectorMarker *SectorMarker;
 
@@ -254,10 +320,9 @@ struct FLevelLocals : public FLevelData
 	DSeqNode *SequenceListHead;
 
 	// [RH] particle globals
-	uint32_t			ActiveParticles;
-	uint32_t			InactiveParticles;
-	TArray<particle_t>	Particles;
-	TArray<uint16_t>	ParticlesInSubsec;
+	FParticleStore		ParticleStore;
+	TArray<particle_t>	Particles;			// what the renderers see this frame
+	TArray<uint32_t>	ParticlesInSubsec;
 
 	TArray<DVector2>	Scrolls;		// NULL if no DScrollers in this level
 
@@ -65,7 +65,8 @@
 #include "actorinlines.h"
 #include "memarena.h"
 
-static FMemArena DynLightArena(sizeof(FDynamicLight) * 200);
+static FMemoryAccount DynLightMemory("Dynamic lights");
+static FMemArena DynLightArena(sizeof(FDynamicLight) * 200, &DynLightMemory);
 static TArray<FDynamicLight*> FreeList;
 static FRandom randLight;
 
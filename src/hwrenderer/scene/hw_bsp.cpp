@@ -99,6 +99,8 @@ void HWDrawInfo::WorkerThread()
 {
 	sector_t *front, *back;
 
+	FTraceScope::SetThreadName("BSP worker thread");
+	FTraceScope trace("BSP worker");
 	WTTotal.Clock();
 	isWorkerThread = true;	// for adding asserts in GL API code. The worker thread may never call any GL API.
 	while (true)
@@ -554,7 +556,7 @@ void HWDrawInfo::RenderThings(subsector_t * sub, sector_t * sector)
 void HWDrawInfo::RenderParticles(subsector_t *sub, sector_t *front)
 {
 	SetupSprite.Clock();
-	for (int i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = Level->Particles[i].snext)
+	for (uint32_t i = Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = Level->Particles[i].snext)
 	{
 		if (mClipPortal)
 		{
@@ -793,6 +795,7 @@ void HWDrawInfo::RenderBSPNode (void *node)
 
 void HWDrawInfo::RenderBSP(void *node)
 {
+	FTraceScope trace("BSP");
 	Bsp.Clock();
 
 	// Give the DrawInfo the viewpoint in fixed point because that's what the nodes are.
@@ -813,7 +816,10 @@ void HWDrawInfo::RenderBSP(void *node)
 		jobQueue.AddJob(RenderJob::TerminateJob, nullptr, nullptr);
 		Bsp.Unclock();
 		MTWait.Clock();
-		future.wait();
+		{
+			FTraceScope wait("BSP wait");
+			future.wait();
+		}
 		MTWait.Unclock();
 	}
 	else
@@ -464,6 +464,7 @@ void HWDrawInfo::CreateScene()
 
 void HWDrawInfo::RenderScene(FRenderState &state)
 {
+	FTraceScope trace("RenderScene");
 	const auto &vp = Viewpoint;
 	RenderAll.Clock();
 
@@ -38,7 +38,8 @@
 #include "hw_drawinfo.h"
 #include "hw_fakeflat.h"
 
-FMemArena RenderDataAllocator(1024*1024);	// Use large blocks to reduce allocation time.
+FMemoryAccount HWRenderMemory("Hardware renderer");
+FMemArena RenderDataAllocator(1024*1024, &HWRenderMemory);	// Use large blocks to reduce allocation time.
 
 void ResetRenderDataAllocator()
 {
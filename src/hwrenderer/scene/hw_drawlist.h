@@ -2,6 +2,7 @@
 
 #include "memarena.h"
 
+extern FMemoryAccount HWRenderMemory;
 extern FMemArena RenderDataAllocator;
 void ResetRenderDataAllocator();
 struct HWDrawInfo;
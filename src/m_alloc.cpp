@@ -44,8 +44,11 @@
 #include <malloc.h>
 #endif
 
+#include <algorithm>
 #include "i_system.h"
 #include "dobject.h"
+#include "stats.h"
+#include "c_dispatch.h"
 
 #ifndef _MSC_VER
 #define _NORMAL_BLOCK			0
@@ -219,3 +222,98 @@ void M_Free (void *block)
 }
 #endif
 
+
+//==========================================================================
+//
+// Memory accounting
+//
+//==========================================================================
+
+FMemoryAccount *FMemoryAccount::First;
+FMemoryAccount ArenaMemory("Other arenas");
+
+FMemoryAccount::FMemoryAccount(const char *name, size_t (*measure)())
+{
+	Name = name;
+	Measure = measure;
+	Next = First;
+	First = this;
+}
+
+FMemoryAccount::~FMemoryAccount()
+{
+	FMemoryAccount **prev = &First;
+
+	while (*prev && *prev != this)
+		prev = &(*prev)->Next;
+
+	if (*prev == this)
+		*prev = Next;
+}
+
+void FMemoryAccount::Update()
+{
+	if (Measure != nullptr)
+	{
+		size_t current = Measure();
+		Current = current;
+		if (current > Peak)
+		{
+			Peak = current;
+		}
+	}
+}
+
+void FMemoryAccount::UpdateAll()
+{
+	for (auto account = First; account != nullptr; account = account->Next)
+	{
+		account->Update();
+	}
+}
+
+static void SortMemoryAccounts(TArray<FMemoryAccount *> &accounts)
+{
+	accounts.Clear();
+	for (auto account = FMemoryAccount::GetFirst(); account != nullptr; account = account->GetNext())
+	{
+		accounts.Push(account);
+	}
+	std::sort(accounts.begin(), accounts.end(), [](FMemoryAccount *a, FMemoryAccount *b)
+	{
+		return a->GetCurrent() > b->GetCurrent();
+	});
+}
+
+ADD_STAT(memory)
+{
+	TArray<FMemoryAccount *> accounts;
+	FString out;
+
+	FMemoryAccount::UpdateAll();
+	SortMemoryAccounts(accounts);
+	for (auto account : accounts)
+	{
+		out.AppendFormat("%-28s %8.2f MB (peak %8.2f MB)\n", account->GetName(),
+			account->GetCurrent() / 1048576., account->GetPeak() / 1048576.);
+	}
+	out.AppendFormat("M_Malloc total %.2f MB", GC::AllocBytes / 1048576.);
+	return out;
+}
+
+CCMD(dumpmemory)
+{
+	TArray<FMemoryAccount *> accounts;
+	size_t total = 0;
+
+	FMemoryAccount::UpdateAll();
+	SortMemoryAccounts(accounts);
+	Printf("%-28s %14s %14s\n", "Subsystem", "Current", "Peak");
+	for (auto account : accounts)
+	{
+		Printf("%-28s %14zu %14zu\n", account->GetName(), account->GetCurrent(), account->GetPeak());
+		total += account->GetCurrent();
+	}
+	Printf("%-28s %14zu\n", "Accounted", total);
+	Printf("%-28s %14zu\n", "M_Malloc total", GC::AllocBytes);
+}
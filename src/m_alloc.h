@@ -35,6 +35,7 @@
 #define __M_ALLOC_H__
 
 #include <stdlib.h>
+#include <atomic>
 
 // These are the same as the same stdlib functions,
 // except they bomb out with a fatal error
@@ -53,4 +54,56 @@ void *M_Realloc (void *memblock, size_t size);
 
 void M_Free (void *memblock);
 
+// Memory accounting per subsystem. Arenas and other owners of large
+// allocations either add and remove their memory as it gets allocated and
+// freed or provide a function that measures it when the accounts get
+// updated. In the latter case the peak is only the highest value that has
+// been seen by an update. The current state can be seen with 'stat memory'
+// and 'dumpmemory'.
+class FMemoryAccount
+{
+public:
+	FMemoryAccount(const char *name, size_t (*measure)() = nullptr);
+	~FMemoryAccount();
+
+	void Add(size_t bytes)
+	{
+		size_t current = Current += bytes;
+		size_t peak = Peak;
+		while (current > peak && !Peak.compare_exchange_weak(peak, current))
+		{
+		}
+	}
+
+	void Sub(size_t bytes)
+	{
+		Current -= bytes;
+	}
+
+	size_t GetCurrent() const { return Current; }
+	size_t GetPeak() const { return Peak; }
+	const char *GetName() const { return Name; }
+	FMemoryAccount *GetNext() const { return Next; }
+
+	void Update();
+
+	static FMemoryAccount *GetFirst() { return First; }
+	static void UpdateAll();
+
+private:
+	// The counters must not get initialized by the constructor, because an
+	// arena may already have allocated memory during static initialization.
+	std::atomic<size_t> Current;
+	std::atomic<size_t> Peak;
+
+	const char *Name;
+	size_t (*Measure)();
+	FMemoryAccount *Next;
+
+	static FMemoryAccount *First;
+};
+
+// For arenas that have not been assigned to a subsystem.
+extern FMemoryAccount ArenaMemory;
+
 #endif //__M_ALLOC_H__
@@ -946,7 +946,7 @@ bool MapLoader::CheckNodes(MapData * map, bool rebuilt, int buildtime)
 typedef TArray<uint8_t> MemFile;
 
 
-static FString CreateCacheName(MapData *map, bool create)
+FString CreateCacheName(MapData *map, bool create, const char *ext)
 {
 	FString path = M_GetCachePath(create);
 	FString lumpname = Wads.GetLumpFullPath(map->lumpnum);
@@ -956,7 +956,7 @@ static FString CreateCacheName(MapData *map, bool create)
 
 	lumpname.ReplaceChars('/', '%');
 	lumpname.ReplaceChars(':', '$');
-	path << '/' << lumpname.Right(lumpname.Len() - separator - 1) << ".gzc";
+	path << '/' << lumpname.Right(lumpname.Len() - separator - 1) << ext;
 	return path;
 }
 
@@ -2622,8 +2622,7 @@ void MapLoader::LoadBlockMap (MapData * map)
 
 	// clear out mobj chains
 	count = Level->blockmap.bmapwidth*Level->blockmap.bmapheight;
-	Level->blockmap.blocklinks = new FBlockNode *[count];
-	memset (Level->blockmap.blocklinks, 0, count*sizeof(*Level->blockmap.blocklinks));
+	Level->blockmap.blocklinks = new TArray<FBlockLink>[count];
 	Level->blockmap.blockmap = Level->blockmap.blockmaplump+4;
 }
 
@@ -3237,4 +3236,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	PO_Init();				// Initialize the polyobjs
 	if (!Level->IsReentering())
 		P_FinalizePortals(Level);	// finalize line portals after polyobjects have been initialized. This info is needed for properly flagging them.
+
+	// Needs to know about polyobjects and linked portals.
+	BuildSightPVS(map, false);
 }
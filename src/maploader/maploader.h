@@ -92,6 +92,9 @@ typedef TMap<FString,FMissingCount> FMissingTextureTracker;
 struct FLevelLocals;
 struct MapData;
 
+// Name of a map's file in the node cache. Also used for the sight PVS.
+FString CreateCacheName(MapData *map, bool create, const char *ext = ".gzc");
+
 class MapLoader
 {
 	friend class UDMFParser;
@@ -266,6 +269,7 @@ public:
 	void CopySlopes();
 
 	void LoadLevel(MapData *map, const char *lumpname, int position);
+	void BuildSightPVS(MapData *map, bool offline);
 
 	MapLoader(FLevelLocals *lev)
 	{
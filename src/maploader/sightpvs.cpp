@@ -0,0 +1,600 @@
+//-----------------------------------------------------------------------------
+//
+// Copyright 2018 GZDoom Development Team
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/
+//
+//-----------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//		Sector to sector sight matrix for maps without a REJECT lump
+//
+// A sight trace is a straight line in the map plane which may only cross
+// two-sided lines. The matrix is built by flooding through the two-sided
+// lines between sectors, the same way Quake's vis does it with portals:
+// The lines that have been passed so far restrict where the trace can
+// go, and any sector that cannot be reached by a straight line from a
+// sector cannot be seen from it either.
+//
+// Everything that can change during play is treated as open: Heights,
+// line flags and 3D floors are ignored and polyobject lines are left out,
+// because all of them can only block sight but never open a new path.
+// This means the matrix never needs to be updated. Maps with linked
+// portals don't get one, like they also don't use their REJECT lump.
+//
+// Unlike REJECT the matrix is only checked right before the sight trace
+// so that it cannot change any results or the random number sequence.
+//
+//-----------------------------------------------------------------------------
+
+#include <zlib.h>
+#include "templates.h"
+#include "c_cvars.h"
+#include "c_dispatch.h"
+#include "m_swap.h"
+#include "files.h"
+#include "i_time.h"
+#include "doomstat.h"
+#include "p_local.h"
+#include "p_setup.h"
+#include "g_levellocals.h"
+#include "maploader.h"
+
+CVAR(Bool, sv_sightpvs, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+EXTERN_CVAR(Bool, gl_cachenodes)
+EXTERN_CVAR(Float, gl_cachetime)
+
+enum
+{
+	PVS_VERSION = 1,
+	MAX_PVS_SECTORS = 16384,		// 32 MB for the matrix
+	MAX_PVS_STEPS = 200000,			// per sector, after that the whole area the sector belongs to is considered visible
+	MAX_PVS_TIME = 3000,			// ms, when building while a map loads
+};
+
+static const double CLIP_EPSILON = 1 / 64.;
+
+struct FPVSWinding
+{
+	DVector2 p[2];
+};
+
+struct FPVSPortal
+{
+	FPVSWinding w;	// the sector being entered is on the left side
+	int line;
+	int to;
+};
+
+static double Cross(const DVector2 &a, const DVector2 &b)
+{
+	return a.X * b.Y - a.Y * b.X;
+}
+
+//==========================================================================
+//
+// ClipWinding
+//
+// Keeps the part of w that lies on the given side of the line through
+// a with direction dir. Points that are less than CLIP_EPSILON away
+// from the wrong side are kept.
+//
+//==========================================================================
+
+static bool ClipWinding(FPVSWinding &w, const DVector2 &a, const DVector2 &dir, double side)
+{
+	double len = dir.Length();
+	if (len < CLIP_EPSILON) return true;
+
+	double d0 = side * Cross(dir, w.p[0] - a) / len + CLIP_EPSILON;
+	double d1 = side * Cross(dir, w.p[1] - a) / len + CLIP_EPSILON;
+	if (d0 >= 0 && d1 >= 0) return true;
+	if (d0 < 0 && d1 < 0) return false;
+
+	DVector2 mid = w.p[0] + (w.p[1] - w.p[0]) * (d0 / (d0 - d1));
+	if (d0 < 0) w.p[0] = mid;
+	else w.p[1] = mid;
+	return true;
+}
+
+//==========================================================================
+//
+// ClipToSeparators
+//
+// Clips target to the area that can be reached by a straight line which
+// passes through both source and pass. The separators are the lines
+// through one end of source and one end of pass which have source and
+// pass on opposite sides. Degenerate cases don't clip anything.
+//
+//==========================================================================
+
+static bool ClipToSeparators(const FPVSWinding &source, const FPVSWinding &pass, FPVSWinding &target)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			const DVector2 &a = source.p[i];
+			DVector2 dir = pass.p[j] - a;
+			double len = dir.Length();
+			if (len < CLIP_EPSILON) continue;
+
+			double sourceside = Cross(dir, source.p[i ^ 1] - a) / len;
+			double passside = Cross(dir, pass.p[j ^ 1] - a) / len;
+			if (fabs(sourceside) < CLIP_EPSILON || fabs(passside) < CLIP_EPSILON) continue;
+			if ((sourceside > 0) == (passside > 0)) continue;
+
+			if (!ClipWinding(target, a, dir, passside > 0 ? 1 : -1)) return false;
+		}
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// FSightPVSBuilder
+//
+//==========================================================================
+
+class FSightPVSBuilder
+{
+	FLevelLocals *Level;
+	unsigned NumSectors;
+	unsigned RowWords;
+	TArray<FPVSPortal> Portals;
+	TArray<unsigned> FirstPortal;		// per sector, with an extra entry at the end
+	TArray<bool> LineInStack;
+	TArray<int> Component;
+	TArray<uint64_t> Visible;			// one row per sector
+	uint64_t *Row;
+	int Steps;
+	bool Overflow;
+
+	void Mark(int sector)
+	{
+		Row[sector >> 6] |= uint64_t(1) << (sector & 63);
+	}
+
+	bool IsVisible(unsigned from, unsigned to) const
+	{
+		return !!(Visible[from * RowWords + (to >> 6)] & (uint64_t(1) << (to & 63)));
+	}
+
+	static bool IsPolyLine(const line_t *line)
+	{
+		return (line->sidedef[0] != nullptr && (line->sidedef[0]->Flags & WALLF_POLYOBJ)) ||
+			(line->sidedef[1] != nullptr && (line->sidedef[1]->Flags & WALLF_POLYOBJ));
+	}
+
+	int FindComponent(int sec)
+	{
+		while (Component[sec] != sec)
+		{
+			Component[sec] = Component[Component[sec]];
+			sec = Component[sec];
+		}
+		return sec;
+	}
+
+	void CollectPortals();
+	void Flow(int sector, const FPVSWinding &source, const FPVSWinding &pass, const FPVSPortal &passportal, bool first);
+	void AddNeighbours();
+
+public:
+	FSightPVSBuilder(FLevelLocals *lev) : Level(lev) {}
+
+	bool CheckGeometry();
+	bool Build(TArray<uint8_t> &matrix, uint64_t deadline);
+};
+
+//==========================================================================
+//
+// FSightPVSBuilder :: CheckGeometry
+//
+// The flood relies on every sector being closed by its lines and on the
+// BSP putting each point into the sector its lines say it is in. Tricks
+// like self-referencing sectors break this, so those maps are skipped.
+//
+//==========================================================================
+
+bool FSightPVSBuilder::CheckGeometry()
+{
+	for (auto &sub : Level->subsectors)
+	{
+		DVector2 center = { 0, 0 };
+		for (unsigned i = 0; i < sub.numlines; i++)
+		{
+			seg_t *seg = sub.firstline + i;
+			center += seg->v1->fPos();
+
+			if (seg->linedef != nullptr)
+			{
+				if (IsPolyLine(seg->linedef)) continue;
+				if (seg->sidedef != nullptr && seg->sidedef->sector != sub.sector) return false;
+			}
+			else if (seg->PartnerSeg != nullptr && seg->PartnerSeg->Subsector != nullptr && seg->PartnerSeg->Subsector->sector != sub.sector)
+			{
+				return false;	// sectors touching without a line between them
+			}
+		}
+
+		// The gameplay nodes may differ from the render nodes.
+		if (Level->gamenodes.Size() > 0 && sub.numlines > 0)
+		{
+			center /= sub.numlines;
+			if (P_PointInSubsector(Level, center.X, center.Y)->sector != sub.sector) return false;
+		}
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// FSightPVSBuilder :: CollectPortals
+//
+// Every two-sided line between two different sectors can be passed in
+// both directions.
+//
+//==========================================================================
+
+void FSightPVSBuilder::CollectPortals()
+{
+	NumSectors = Level->sectors.Size();
+	RowWords = (NumSectors + 63) / 64;
+
+	TArray<TArray<FPVSPortal>> sectorportals(NumSectors, true);
+	Component.Resize(NumSectors);
+	for (unsigned i = 0; i < NumSectors; i++) Component[i] = i;
+
+	for (auto &line : Level->lines)
+	{
+		if (line.sidedef[0] == nullptr || line.sidedef[1] == nullptr || IsPolyLine(&line)) continue;
+
+		int front = line.sidedef[0]->sector->Index();
+		int back = line.sidedef[1]->sector->Index();
+		if (front == back) continue;
+
+		// The front side is on the right when going from v1 to v2.
+		DVector2 v1 = line.v1->fPos(), v2 = line.v2->fPos();
+		sectorportals[front].Push({ { { v1, v2 } }, line.Index(), back });
+		sectorportals[back].Push({ { { v2, v1 } }, line.Index(), front });
+
+		Component[FindComponent(front)] = FindComponent(back);
+	}
+
+	FirstPortal.Resize(NumSectors + 1);
+	for (unsigned i = 0; i < NumSectors; i++)
+	{
+		FirstPortal[i] = Portals.Size();
+		Portals.Append(sectorportals[i]);
+	}
+	FirstPortal[NumSectors] = Portals.Size();
+	LineInStack.Resize(Level->lines.Size());
+	memset(LineInStack.Data(), 0, LineInStack.Size() * sizeof(bool));
+}
+
+//==========================================================================
+//
+// FSightPVSBuilder :: Flow
+//
+// The trace has entered sector through passportal and the parts of the
+// source and pass lines it can have gone through are known. A straight
+// line can cross each line only once and it must go through the next
+// line on the far side of the one it just passed.
+//
+//==========================================================================
+
+void FSightPVSBuilder::Flow(int sector, const FPVSWinding &source, const FPVSWinding &pass, const FPVSPortal &passportal, bool first)
+{
+	if (++Steps > MAX_PVS_STEPS)
+	{
+		Overflow = true;
+		return;
+	}
+
+	DVector2 passdir = passportal.w.p[1] - passportal.w.p[0];
+
+	for (unsigned i = FirstPortal[sector]; i < FirstPortal[sector + 1] && !Overflow; i++)
+	{
+		const FPVSPortal &portal = Portals[i];
+		if (LineInStack[portal.line]) continue;
+
+		FPVSWinding target = portal.w;
+		if (!ClipWinding(target, passportal.w.p[0], passdir, 1)) continue;
+		if (!first && !ClipToSeparators(source, pass, target)) continue;
+
+		Mark(portal.to);
+
+		// Narrow down where on the source line the trace may have started.
+		FPVSWinding newsource = source;
+		if (!ClipWinding(newsource, portal.w.p[0], portal.w.p[1] - portal.w.p[0], -1)) continue;
+		if (!first && !ClipToSeparators(target, pass, newsource)) continue;
+
+		LineInStack[portal.line] = true;
+		Flow(portal.to, newsource, target, portal, false);
+		LineInStack[portal.line] = false;
+	}
+}
+
+//==========================================================================
+//
+// FSightPVSBuilder :: AddNeighbours
+//
+// Actors spawned right on a vertex may be in a sector that only touches
+// the area the trace really starts in, so each sector also gets what
+// all sectors sharing a vertex with it can see.
+//
+//==========================================================================
+
+void FSightPVSBuilder::AddNeighbours()
+{
+	TArray<TArray<int>> vertexsectors(Level->vertexes.Size(), true);
+	for (auto &line : Level->lines)
+	{
+		if (IsPolyLine(&line)) continue;
+		for (int s = 0; s < 2; s++)
+		{
+			if (line.sidedef[s] == nullptr) continue;
+			int sec = line.sidedef[s]->sector->Index();
+			for (vertex_t *v : { line.v1, line.v2 })
+			{
+				auto &list = vertexsectors[v->Index()];
+				if (list.Find(sec) == list.Size()) list.Push(sec);
+			}
+		}
+	}
+
+	TArray<uint64_t> merged = Visible;
+	for (auto &list : vertexsectors)
+	{
+		for (unsigned i = 0; i < list.Size(); i++)
+		{
+			for (unsigned j = 0; j < list.Size(); j++)
+			{
+				if (i == j) continue;
+				uint64_t *dest = &merged[list[i] * RowWords];
+				const uint64_t *src = &Visible[list[j] * RowWords];
+				for (unsigned w = 0; w < RowWords; w++) dest[w] |= src[w];
+			}
+		}
+	}
+	Visible = std::move(merged);
+}
+
+//==========================================================================
+//
+// FSightPVSBuilder :: Build
+//
+// Creates the matrix in the same layout as REJECT but with the bits set
+// for pairs of sectors that may see each other. Once the deadline has
+// passed all remaining sectors only get the area they belong to.
+//
+//==========================================================================
+
+bool FSightPVSBuilder::Build(TArray<uint8_t> &matrix, uint64_t deadline)
+{
+	CollectPortals();
+
+	Visible.Resize(NumSectors * RowWords);
+	memset(Visible.Data(), 0, Visible.Size() * sizeof(uint64_t));
+
+	int overflows = 0;
+	for (unsigned sec = 0; sec < NumSectors; sec++)
+	{
+		Row = &Visible[sec * RowWords];
+		Mark(sec);
+		Steps = 0;
+		Overflow = deadline != 0 && I_msTime() >= deadline;
+
+		for (unsigned i = FirstPortal[sec]; i < FirstPortal[sec + 1] && !Overflow; i++)
+		{
+			const FPVSPortal &portal = Portals[i];
+			Mark(portal.to);
+			LineInStack[portal.line] = true;
+			Flow(portal.to, portal.w, portal.w, portal, true);
+			LineInStack[portal.line] = false;
+		}
+
+		if (Overflow)
+		{
+			int comp = FindComponent(sec);
+			for (unsigned other = 0; other < NumSectors; other++)
+			{
+				if (FindComponent(other) == comp) Mark(other);
+			}
+			overflows++;
+		}
+	}
+	if (overflows > 0)
+	{
+		DPrintf(DMSG_NOTIFY, "Sight PVS: %d of %u sectors were not fully processed\n", overflows, NumSectors);
+	}
+
+	AddNeighbours();
+
+	// A straight line can be followed both ways so either side finding it is enough.
+	matrix.Resize((NumSectors * NumSectors + 7) / 8);
+	memset(matrix.Data(), 0, matrix.Size());
+	unsigned rejected = 0;
+	for (unsigned from = 0; from < NumSectors; from++)
+	{
+		for (unsigned to = 0; to < NumSectors; to++)
+		{
+			if (IsVisible(from, to) || IsVisible(to, from))
+			{
+				unsigned pnum = from * NumSectors + to;
+				matrix[pnum >> 3] |= 1 << (pnum & 7);
+			}
+			else rejected++;
+		}
+	}
+	Visible.Reset();
+	Portals.Reset();
+	return rejected > 0;
+}
+
+//==========================================================================
+//
+// Sight PVS caching
+//
+// This goes next to the node cache. The map's checksum makes sure that
+// it only gets used for the same map.
+//
+//==========================================================================
+
+static void WriteCachedSightPVS(MapData *map, FLevelLocals *Level)
+{
+	auto &matrix = Level->sightpvs;
+	uLongf outlen = compressBound(matrix.Size());
+	TArray<Bytef> compressed(outlen, true);
+	if (compress(compressed.Data(), &outlen, matrix.Data(), matrix.Size()) != Z_OK)
+	{
+		return;
+	}
+
+	uint32_t header[4] = { LittleLong(uint32_t(PVS_VERSION)), LittleLong(Level->sectors.Size()), LittleLong(Level->lines.Size()), LittleLong(matrix.Size()) };
+	uint8_t md5[16];
+	map->GetChecksum(md5);
+
+	FString path = CreateCacheName(map, true, ".gzp");
+	FileWriter *fw = FileWriter::Open(path);
+	if (fw != nullptr)
+	{
+		if (fw->Write("SPVS", 4) != 4 || fw->Write(header, sizeof(header)) != sizeof(header) ||
+			fw->Write(md5, 16) != 16 || fw->Write(compressed.Data(), outlen) != outlen)
+		{
+			Printf("Error saving sight PVS to file %s\n", path.GetChars());
+		}
+		delete fw;
+	}
+	else
+	{
+		Printf("Cannot open sight PVS file %s for writing\n", path.GetChars());
+	}
+}
+
+static bool ReadCachedSightPVS(MapData *map, FLevelLocals *Level)
+{
+	char magic[4];
+	uint32_t header[4];
+	uint8_t md5[16], md5map[16];
+
+	FString path = CreateCacheName(map, false, ".gzp");
+	FileReader fr;
+
+	if (!fr.OpenFile(path)) return false;
+	if (fr.Read(magic, 4) != 4 || memcmp(magic, "SPVS", 4)) return false;
+	if (fr.Read(header, sizeof(header)) != sizeof(header)) return false;
+	if (LittleLong(header[0]) != PVS_VERSION || LittleLong(header[1]) != Level->sectors.Size() || LittleLong(header[2]) != Level->lines.Size()) return false;
+
+	uLongf size = LittleLong(header[3]);
+	if (size != (Level->sectors.Size() * Level->sectors.Size() + 7) / 8) return false;
+
+	if (fr.Read(md5, 16) != 16) return false;
+	map->GetChecksum(md5map);
+	if (memcmp(md5, md5map, 16)) return false;
+
+	auto compressed = fr.Read();
+	Level->sightpvs.Resize(size);
+	if (uncompress(Level->sightpvs.Data(), &size, compressed.Data(), compressed.Size()) != Z_OK || size != Level->sightpvs.Size())
+	{
+		Level->sightpvs.Reset();
+		return false;
+	}
+	return true;
+}
+
+//==========================================================================
+//
+// MapLoader :: BuildSightPVS
+//
+// Only used when the map has no usable REJECT lump. If offline is set
+// there is no time limit and the result always gets cached.
+//
+//==========================================================================
+
+void MapLoader::BuildSightPVS(MapData *map, bool offline)
+{
+	Level->sightpvs.Reset();
+
+	if (!sv_sightpvs || Level->rejectmatrix.Size() > 0 || Level->Displacements.size > 1) return;
+	if (Level->sectors.Size() < 2 || Level->sectors.Size() > MAX_PVS_SECTORS) return;
+
+	if (!offline && ReadCachedSightPVS(map, Level))
+	{
+		return;
+	}
+
+	FSightPVSBuilder builder(Level);
+	if (!builder.CheckGeometry())
+	{
+		DPrintf(DMSG_NOTIFY, "Not building sight PVS because of broken sectors\n");
+		return;
+	}
+
+	uint64_t startTime = I_msTime();
+	if (!builder.Build(Level->sightpvs, offline ? 0 : startTime + MAX_PVS_TIME))
+	{
+		// Everything can see everything else.
+		Level->sightpvs.Reset();
+	}
+	uint64_t buildtime = I_msTime() - startTime;
+	DPrintf(DMSG_NOTIFY, "Sight PVS generation took %.3f sec\n", buildtime * 0.001);
+
+	if (Level->sightpvs.Size() > 0 && (offline || (gl_cachenodes && buildtime / 1000.f >= gl_cachetime)))
+	{
+		WriteCachedSightPVS(map, Level);
+	}
+}
+
+//==========================================================================
+//
+// CCMD buildsightpvs
+//
+// Builds the sight PVS for the current map without any time limit and
+// stores it in the cache.
+//
+//==========================================================================
+
+CCMD(buildsightpvs)
+{
+	if (gamestate != GS_LEVEL)
+	{
+		Printf("No map loaded\n");
+		return;
+	}
+
+	ForAllLevels([](FLevelLocals *Level)
+	{
+		MapData *map = P_OpenMapData(Level->MapName, true);
+		if (map == nullptr)
+		{
+			Printf("Unable to open map data for %s\n", Level->MapName.GetChars());
+			return;
+		}
+
+		MapLoader loader(Level);
+		loader.BuildSightPVS(map, true);
+		delete map;
+
+		if (Level->sightpvs.Size() > 0)
+		{
+			Printf("Sight PVS for %s built and cached\n", Level->MapName.GetChars());
+		}
+		else
+		{
+			Printf("No sight PVS could be built for %s\n", Level->MapName.GetChars());
+		}
+	});
+}
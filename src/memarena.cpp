@@ -71,11 +71,12 @@ static inline void *RoundPointer(void *ptr)
 //
 //==========================================================================
 
-FMemArena::FMemArena(size_t blocksize)
+FMemArena::FMemArena(size_t blocksize, FMemoryAccount *account)
 {
 	TopBlock = NULL;
 	FreeBlocks = NULL;
 	BlockSize = blocksize;
+	Account = account;
 }
 
 //==========================================================================
@@ -200,6 +201,7 @@ void FMemArena::FreeBlockChain(Block *&top)
 	for (Block *next, *block = top; block != NULL; block = next)
 	{
 		next = block->NextBlock;
+		Account->Sub((uint8_t *)block->Limit - (uint8_t *)block);
 		M_Free(block);
 	}
 	top = NULL;
@@ -242,6 +244,7 @@ FMemArena::Block *FMemArena::AddBlock(size_t size)
 		}
 		mem = (Block *)M_Malloc(size);
 		mem->Limit = (uint8_t *)mem + size;
+		Account->Add(size);
 	}
 	mem->Reset();
 	mem->NextBlock = TopBlock;
@@ -287,7 +290,8 @@ void *FMemArena::Block::Alloc(size_t size)
 //
 //==========================================================================
 
-FSharedStringArena::FSharedStringArena()
+FSharedStringArena::FSharedStringArena(FMemoryAccount *account)
+	: FMemArena(10*1024, account)
 {
 	memset(Buckets, 0, sizeof(Buckets));
 }
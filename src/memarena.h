@@ -35,12 +35,13 @@
 #define __MEMARENA_H
 
 #include "zstring.h"
+#include "m_alloc.h"
 
 // A general purpose arena.
 class FMemArena
 {
 public:
-	FMemArena(size_t blocksize = 10*1024);
+	FMemArena(size_t blocksize = 10*1024, FMemoryAccount *account = &ArenaMemory);
 	~FMemArena();
 
 	void *Alloc(size_t size);
@@ -59,6 +60,7 @@ protected:
 	Block *TopBlock;
 	Block *FreeBlocks;
 	size_t BlockSize;
+	FMemoryAccount *Account;
 };
 
 // An arena specializing in storage of FStrings. It knows how to free them,
@@ -67,7 +69,7 @@ protected:
 class FSharedStringArena : public FMemArena
 {
 public:
-	FSharedStringArena();
+	FSharedStringArena(FMemoryAccount *account = &ArenaMemory);
 	~FSharedStringArena();
 	void FreeAll();
 
@@ -43,6 +43,7 @@
 
 #include "doomdata.h"
 #include "nodebuild.h"
+#include "m_alloc.h"
 
 const int MaxSegs = 64;
 const int SplitCost = 8;
@@ -54,8 +55,10 @@ const int AAPreference = 16;
 #define D(x) do{}while(0)
 #endif
 
+static FMemoryAccount NodeBuilderMemory("Node builder");
+
 FNodeBuilder::FNodeBuilder(FLevel &_level)
-: Level(_level), GLNodes(false), SegsStuffed(0)
+: Level(_level), GLNodes(false), SegsStuffed(0), AccountedMemory(0)
 {
 	VertexMap = NULL;
 	OldVertexTable = NULL;
@@ -64,7 +67,7 @@ FNodeBuilder::FNodeBuilder(FLevel &_level)
 FNodeBuilder::FNodeBuilder (FLevel &_level,
 							TArray<FPolyStart> &polyspots, TArray<FPolyStart> &anchors,
 							bool makeGLNodes)
-	: Level(_level), GLNodes(makeGLNodes), SegsStuffed(0)
+	: Level(_level), GLNodes(makeGLNodes), SegsStuffed(0), AccountedMemory(0)
 {
 	VertexMap = new FVertexMap (*this, Level.MinX, Level.MinY, Level.MaxX, Level.MaxY);
 	FindUsedVertices (Level.Vertices, Level.NumVertices);
@@ -84,6 +87,7 @@ FNodeBuilder::~FNodeBuilder()
 	{
 		delete[] OldVertexTable;
 	}
+	NodeBuilderMemory.Sub(AccountedMemory);
 }
 
 void FNodeBuilder::BuildMini(bool makeGLNodes)
@@ -121,6 +125,29 @@ void FNodeBuilder::BuildTree ()
 	HackMate = DWORD_MAX;
 	CreateNode (0, Segs.Size(), bbox);
 	CreateSubsectorsForReal ();
+	UpdateMemoryAccount ();
+}
+
+// The work arrays are at their largest once the tree has been built and
+// they only get released when the builder is destroyed.
+void FNodeBuilder::UpdateMemoryAccount ()
+{
+	size_t bytes =
+		Nodes.Max() * sizeof(node_t) +
+		Subsectors.Max() * sizeof(subsector_t) +
+		SubsectorSets.Max() * sizeof(uint32_t) +
+		Segs.Max() * sizeof(FPrivSeg) +
+		Vertices.Max() * sizeof(FPrivVert) +
+		SegList.Max() * sizeof(USegPtr) +
+		PlaneChecked.Max() * sizeof(uint8_t) +
+		Planes.Max() * sizeof(FSimpleLine) +
+		Touched.Max() * sizeof(int) +
+		Colinear.Max() * sizeof(int) +
+		SplitSharers.Max() * sizeof(FSplitSharer);
+
+	NodeBuilderMemory.Sub(AccountedMemory);
+	NodeBuilderMemory.Add(bytes);
+	AccountedMemory = bytes;
 }
 
 int FNodeBuilder::CreateNode (uint32_t set, unsigned int count, fixed_t bbox[4])
@@ -277,8 +277,12 @@ private:
 	// Progress meter stuff
 	int SegsStuffed;
 
+	// Size of the work arrays last reported to the node builder's memory account
+	size_t AccountedMemory;
+
 	void FindUsedVertices (vertex_t *vertices, int max);
 	void BuildTree ();
+	void UpdateMemoryAccount ();
 	void MakeSegsFromSides ();
 	int CreateSeg (int linenum, int sidenum);
 	void GroupSegPlanes ();
@@ -3633,11 +3633,12 @@ do_count:
 	}
 	else
 	{
-		TThinkerIterator<AActor> iterator(Level);
-		while ( (actor = iterator.Next ()) )
+		// With a class given, the iterator only looks at the actors of
+		// that class and its subclasses.
+		TThinkerIterator<AActor> iterator(Level, kind != NULL ? kind : RUNTIME_CLASS(AActor));
+		while ( (actor = iterator.Next (kind != NULL)) )
 		{
-			if (actor->health > 0 &&
-				(kind == NULL || actor->IsA (kind)))
+			if (actor->health > 0)
 			{
 				if (tag == -1 || Level->tagManager.SectorHasTag(actor->Sector, tag))
 				{
@@ -2,18 +2,19 @@
 #define __P_BLOCKMAP_H
 
 #include "doomtype.h"
+#include "tarray.h"
 
 class AActor;
 
 // [RH] Like msecnode_t, but for the blockmap
+// Chains the blocks an actor is linked into. The blocks themselves keep
+// their actors in contiguous arrays of FBlockLinks.
 struct FBlockNode
 {
 	AActor *Me;						// actor this node references
 	int BlockIndex;					// index into blocklinks for the block this node is in
 	int Group;						// portal group this link belongs to (can be different than the actor's own group
-	FBlockNode **PrevActor;			// previous actor in this block
-	FBlockNode *NextActor;			// next actor in this block
-	FBlockNode **PrevBlock;			// previous block this actor is in
+	unsigned Index;					// position of this actor in the block's array
 	FBlockNode *NextBlock;			// next block this actor is in
 
 	static FBlockNode *Create (AActor *who, int x, int y, int group = -1);
@@ -22,6 +23,12 @@ struct FBlockNode
 	static FBlockNode *FreeBlocks;
 };
 
+struct FBlockLink
+{
+	AActor *Me;
+	FBlockNode *Node;
+};
+
 // BLOCKMAP
 // Created from axis aligned bounding box
 // of the map, a rectangular array of
@@ -39,7 +46,7 @@ struct FBlockmap
 	int					bmapheight; 	// in mapblocks
 	double				bmaporgx;
 	double				bmaporgy;		// origin of block map
-	FBlockNode**		blocklinks; 	// for thing chains
+	TArray<FBlockLink>*	blocklinks; 	// for thing lists. Iterate from the back to get the most recently linked actors first.
 
 	// mapblocks are used to check movement
 	// against lines and things
@@ -75,6 +82,36 @@ struct FBlockmap
 
 	bool VerifyBlockMap(int count, unsigned numlines);
 
+	// The order of a block's actors must be kept when removing one because
+	// it decides the order of collision checks and thus affects demo sync.
+	void LinkThing(FBlockNode *node)
+	{
+		auto &block = blocklinks[node->BlockIndex];
+		node->Index = block.Push({ node->Me, node });
+	}
+
+	void UnlinkThing(FBlockNode *node)
+	{
+		auto &block = blocklinks[node->BlockIndex];
+		block.Delete(node->Index);
+		for (unsigned i = node->Index; i < block.Size(); i++)
+		{
+			block[i].Node->Index = i;
+		}
+	}
+
+	// Undoes an UnlinkThing without changing the order of the block.
+	// Must be called in the reverse order of the UnlinkThing calls.
+	void RestoreThing(FBlockNode *node)
+	{
+		auto &block = blocklinks[node->BlockIndex];
+		block.Insert(node->Index, { node->Me, node });
+		for (unsigned i = node->Index + 1; i < block.Size(); i++)
+		{
+			block[i].Node->Index = i;
+		}
+	}
+
 	void Clear()
 	{
 		if (blockmaplump != nullptr)
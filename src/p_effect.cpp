@@ -49,6 +49,10 @@
 #include "actorinlines.h"
 #include "vm.h"
 
+#ifndef NO_SSE
+#include <emmintrin.h>
+#endif
+
 CVAR (Int, cl_rockettrails, 1, CVAR_ARCHIVE);
 CVAR (Bool, r_rail_smartspiral, 0, CVAR_ARCHIVE);
 CVAR (Int, r_rail_spiralsparsity, 1, CVAR_ARCHIVE);
@@ -97,19 +101,93 @@ static const struct ColorList {
 	{NULL, 0, 0, 0 }
 };
 
-inline particle_t *NewParticle (FLevelLocals *Level)
+inline FNewParticle *NewParticle (FLevelLocals *Level)
+{
+	return Level->ParticleStore.NewParticle();
+}
+
+//==========================================================================
+//
+// FParticleStore
+//
+//==========================================================================
+
+void FParticleStore::Init(unsigned capacity)
+{
+	Capacity = capacity;
+
+	// Room for a full block of four so that the SIMD loads never need to
+	// care about the end of the arrays.
+	unsigned size = (capacity + 3) & ~3u;
+	PosX.Resize(size); PosY.Resize(size); PosZ.Resize(size);
+	VelX.Resize(size); VelY.Resize(size); VelZ.Resize(size);
+	AccX.Resize(size); AccY.Resize(size); AccZ.Resize(size);
+	Size.Resize(size); SizeStep.Resize(size);
+	Alpha.Resize(size); FadeStep.Resize(size);
+	TTL.Resize(size);
+	Color.Resize(size);
+	Bright.Resize(size);
+	NoTimeFreeze.Resize(size);
+	Subsector.Resize(size);
+	Clear();
+}
+
+void FParticleStore::Clear()
 {
-	particle_t *result = nullptr;
-	if (Level->InactiveParticles != NO_PARTICLE)
+	Count = 0;
+	NewParticles.Clear();
+}
+
+FNewParticle *FParticleStore::NewParticle()
+{
+	if (Count + NewParticles.Size() >= Capacity)
 	{
-		result = &Level->Particles[Level->InactiveParticles];
-		Level->InactiveParticles = result->tnext;
-		result->tnext = Level->ActiveParticles;
-		Level->ActiveParticles = uint32_t(result - Level->Particles.Data());
+		return nullptr;
 	}
+	FNewParticle *result = &NewParticles[NewParticles.Reserve(1)];
+	memset(result, 0, sizeof(*result));
 	return result;
 }
 
+void FParticleStore::AddNewParticles()
+{
+	for (auto &p : NewParticles)
+	{
+		unsigned i = Count++;
+		PosX[i] = p.Pos.X; PosY[i] = p.Pos.Y; PosZ[i] = p.Pos.Z;
+		VelX[i] = float(p.Vel.X); VelY[i] = float(p.Vel.Y); VelZ[i] = float(p.Vel.Z);
+		AccX[i] = float(p.Acc.X); AccY[i] = float(p.Acc.Y); AccZ[i] = float(p.Acc.Z);
+		Size[i] = float(p.size); SizeStep[i] = float(p.sizestep);
+		Alpha[i] = p.alpha; FadeStep[i] = p.fadestep;
+		TTL[i] = p.ttl;
+		Color[i] = p.color;
+		Bright[i] = p.bright;
+		NoTimeFreeze[i] = p.notimefreeze;
+		Subsector[i] = nullptr;
+	}
+	NewParticles.Clear();
+}
+
+void FParticleStore::Move(unsigned from, unsigned to)
+{
+	PosX[to] = PosX[from]; PosY[to] = PosY[from]; PosZ[to] = PosZ[from];
+	VelX[to] = VelX[from]; VelY[to] = VelY[from]; VelZ[to] = VelZ[from];
+	AccX[to] = AccX[from]; AccY[to] = AccY[from]; AccZ[to] = AccZ[from];
+	Size[to] = Size[from]; SizeStep[to] = SizeStep[from];
+	Alpha[to] = Alpha[from]; FadeStep[to] = FadeStep[from];
+	TTL[to] = TTL[from];
+	Color[to] = Color[from];
+	Bright[to] = Bright[from];
+	NoTimeFreeze[to] = NoTimeFreeze[from];
+	Subsector[to] = Subsector[from];
+}
+
+size_t FParticleStore::MemorySize() const
+{
+	size_t perparticle = 3 * sizeof(double) + 10 * sizeof(float) + sizeof(int32_t) + sizeof(int) + 2 * sizeof(uint8_t) + sizeof(subsector_t *);
+	return PosX.Max() * perparticle + NewParticles.Max() * sizeof(FNewParticle);
+}
+
 //
 // [RH] Particle functions
 //
@@ -121,8 +199,8 @@ CUSTOM_CVAR( Int, r_maxparticles, 4000, CVAR_ARCHIVE )
 {
 	if ( self == 0 )
 		self = 4000;
-	else if (self > 65535)
-		self = 65535;
+	else if (self > MAX_PARTICLES)
+		self = MAX_PARTICLES;
 	else if (self < 100)
 		self = 100;
 
@@ -144,21 +222,16 @@ void P_InitParticles (FLevelLocals *Level)
 		num = r_maxparticles;
 
 	// This should be good, but eh...
-	int NumParticles = clamp<int>(num, 100, 65535);
+	int NumParticles = clamp<int>(num, 100, MAX_PARTICLES);
 
-	Level->Particles.Resize(NumParticles);
+	Level->ParticleStore.Init(NumParticles);
 	P_ClearParticles (Level);
 }
 
 void P_ClearParticles (FLevelLocals *Level)
 {
-	int i = 0;
-	memset (Level->Particles.Data(), 0, Level->Particles.Size() * sizeof(particle_t));
-	Level->ActiveParticles = NO_PARTICLE;
-	Level->InactiveParticles = 0;
-	for (auto &p : Level->Particles)
-		p.tnext = ++i;
-	Level->Particles.Last().tnext = NO_PARTICLE;
+	Level->ParticleStore.Clear();
+	Level->Particles.Clear();
 }
 
 // Group particles by subsectors. Because particles are always
@@ -172,18 +245,35 @@ void P_FindParticleSubsectors (FLevelLocals *Level)
 		Level->ParticlesInSubsec.Reserve (Level->subsectors.Size() - Level->ParticlesInSubsec.Size());
 	}
 
-	fillshort (&Level->ParticlesInSubsec[0], Level->subsectors.Size(), NO_PARTICLE);
+	for (unsigned i = 0; i < Level->subsectors.Size(); i++)
+	{
+		Level->ParticlesInSubsec[i] = NO_PARTICLE;
+	}
 
 	if (!r_particles)
 	{
 		return;
 	}
-	for (uint16_t i = Level->ActiveParticles; i != NO_PARTICLE; i = Level->Particles[i].tnext)
+
+	auto &store = Level->ParticleStore;
+	store.AddNewParticles();
+	Level->Particles.Resize(store.Count);
+	for (unsigned i = 0; i < store.Count; i++)
 	{
 		 // Try to reuse the subsector from the last portal check, if still valid.
-		if (Level->Particles[i].subsector == NULL) Level->Particles[i].subsector = R_PointInSubsector(Level, Level->Particles[i].Pos);
-		int ssnum = Level->Particles[i].subsector->Index();
-		Level->Particles[i].snext = Level->ParticlesInSubsec[ssnum];
+		if (store.Subsector[i] == NULL) store.Subsector[i] = R_PointInSubsector(Level, DVector2(store.PosX[i], store.PosY[i]));
+
+		particle_t &particle = Level->Particles[i];
+		particle.Pos = { store.PosX[i], store.PosY[i], store.PosZ[i] };
+		particle.Vel = { store.VelX[i], store.VelY[i], store.VelZ[i] };
+		particle.size = store.Size[i];
+		particle.subsector = store.Subsector[i];
+		particle.alpha = store.Alpha[i];
+		particle.color = store.Color[i];
+		particle.bright = store.Bright[i];
+
+		int ssnum = particle.subsector->Index();
+		particle.snext = Level->ParticlesInSubsec[ssnum];
 		Level->ParticlesInSubsec[ssnum] = i;
 	}
 }
@@ -225,65 +315,153 @@ void P_InitEffects ()
 	blood2 = ParticleColor(RPART(kind)/3, GPART(kind)/3, BPART(kind)/3);
 }
 
-void P_ThinkParticles (FLevelLocals *Level)
+//==========================================================================
+//
+// ThinkParticle
+//
+// Advances one particle by a tic. Returns false if it has expired.
+//
+//==========================================================================
+
+static bool ThinkParticle (FLevelLocals *Level, FParticleStore &store, unsigned i)
 {
-	int i;
-	particle_t *particle, *prev;
+	float oldtrans = store.Alpha[i];
+	store.Alpha[i] -= store.FadeStep[i];
+	store.Size[i] += store.SizeStep[i];
+	if (store.Alpha[i] <= 0 || oldtrans < store.Alpha[i] || --store.TTL[i] <= 0 || (store.Size[i] <= 0))
+	{ // The particle has expired
+		return false;
+	}
+
+	// Handle crossing a line portal
+	DVector2 newxy = P_GetOffsetPosition(Level, store.PosX[i], store.PosY[i], store.VelX[i], store.VelY[i]);
+	store.PosX[i] = newxy.X;
+	store.PosY[i] = newxy.Y;
+	store.PosZ[i] += store.VelZ[i];
+	store.VelX[i] += store.AccX[i];
+	store.VelY[i] += store.AccY[i];
+	store.VelZ[i] += store.AccZ[i];
+	return true;
+}
+
+#ifndef NO_SSE
+//==========================================================================
+//
+// ThinkParticles4
+//
+// Does the same as ThinkParticle for four particles at once on a level
+// without line portals. Returns a mask of the particles that expired.
+//
+//==========================================================================
+
+static int ThinkParticles4 (FParticleStore &store, unsigned i)
+{
+	__m128 oldalpha = _mm_loadu_ps(&store.Alpha[i]);
+	__m128 alpha = _mm_sub_ps(oldalpha, _mm_loadu_ps(&store.FadeStep[i]));
+	__m128 size = _mm_add_ps(_mm_loadu_ps(&store.Size[i]), _mm_loadu_ps(&store.SizeStep[i]));
+	__m128i ttl = _mm_sub_epi32(_mm_loadu_si128((__m128i*)&store.TTL[i]), _mm_set1_epi32(1));
+	_mm_storeu_ps(&store.Alpha[i], alpha);
+	_mm_storeu_ps(&store.Size[i], size);
+	_mm_storeu_si128((__m128i*)&store.TTL[i], ttl);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 expired = _mm_or_ps(_mm_cmple_ps(alpha, zero), _mm_cmplt_ps(oldalpha, alpha));
+	expired = _mm_or_ps(expired, _mm_castsi128_ps(_mm_cmplt_epi32(ttl, _mm_set1_epi32(1))));
+	expired = _mm_or_ps(expired, _mm_cmple_ps(size, zero));
+
+	double *pos[3] = { &store.PosX[i], &store.PosY[i], &store.PosZ[i] };
+	float *vel[3] = { &store.VelX[i], &store.VelY[i], &store.VelZ[i] };
+	float *acc[3] = { &store.AccX[i], &store.AccY[i], &store.AccZ[i] };
+	for (int j = 0; j < 3; j++)
+	{
+		__m128 v = _mm_loadu_ps(vel[j]);
+		_mm_storeu_pd(pos[j], _mm_add_pd(_mm_loadu_pd(pos[j]), _mm_cvtps_pd(v)));
+		_mm_storeu_pd(pos[j] + 2, _mm_add_pd(_mm_loadu_pd(pos[j] + 2), _mm_cvtps_pd(_mm_movehl_ps(v, v))));
+		_mm_storeu_ps(vel[j], _mm_add_ps(v, _mm_loadu_ps(acc[j])));
+	}
+	return _mm_movemask_ps(expired);
+}
+#endif
+
+//==========================================================================
+//
+// KeepParticle
+//
+// Moves a live particle into its final slot and updates its subsector.
+//
+//==========================================================================
 
-	i = Level->ActiveParticles;
-	prev = NULL;
-	while (i != NO_PARTICLE)
+static void KeepParticle (FLevelLocals *Level, FParticleStore &store, unsigned from, unsigned to)
+{
+	if (from != to) store.Move(from, to);
+
+	DVector3 pos(store.PosX[to], store.PosY[to], store.PosZ[to]);
+	store.Subsector[to] = R_PointInSubsector(Level, pos);
+	sector_t *s = store.Subsector[to]->sector;
+	// Handle crossing a sector portal.
+	if (!s->PortalBlocksMovement(sector_t::ceiling))
 	{
-		particle = &Level->Particles[i];
-		i = particle->tnext;
-		if (!particle->notimefreeze && currentSession->isFrozen())
+		if (pos.Z > s->GetPortalPlaneZ(sector_t::ceiling))
 		{
-			prev = particle;
-			continue;
+			pos += s->GetPortalDisplacement(sector_t::ceiling);
+			store.Subsector[to] = NULL;
 		}
-		
-		auto oldtrans = particle->alpha;
-		particle->alpha -= particle->fadestep;
-		particle->size += particle->sizestep;
-		if (particle->alpha <= 0 || oldtrans < particle->alpha || --particle->ttl <= 0 || (particle->size <= 0))
-		{ // The particle has expired, so free it
-			memset (particle, 0, sizeof(particle_t));
-			if (prev)
-				prev->tnext = i;
-			else
-				Level->ActiveParticles = i;
-			particle->tnext = Level->InactiveParticles;
-			Level->InactiveParticles = (int)(particle - Level->Particles.Data());
-			continue;
+	}
+	else if (!s->PortalBlocksMovement(sector_t::floor))
+	{
+		if (pos.Z < s->GetPortalPlaneZ(sector_t::floor))
+		{
+			pos += s->GetPortalDisplacement(sector_t::floor);
+			store.Subsector[to] = NULL;
 		}
+	}
+	store.PosX[to] = pos.X;
+	store.PosY[to] = pos.Y;
+	store.PosZ[to] = pos.Z;
+}
 
-		// Handle crossing a line portal
-		DVector2 newxy = P_GetOffsetPosition(Level, particle->Pos.X, particle->Pos.Y, particle->Vel.X, particle->Vel.Y);
-		particle->Pos.X = newxy.X;
-		particle->Pos.Y = newxy.Y;
-		particle->Pos.Z += particle->Vel.Z;
-		particle->Vel += particle->Acc;
-		particle->subsector = R_PointInSubsector(Level, particle->Pos);
-		sector_t *s = particle->subsector->sector;
-		// Handle crossing a sector portal.
-		if (!s->PortalBlocksMovement(sector_t::ceiling))
+void P_ThinkParticles (FLevelLocals *Level)
+{
+	auto &store = Level->ParticleStore;
+	store.AddNewParticles();
+
+	bool frozen = currentSession->isFrozen();
+	unsigned count = store.Count;
+	unsigned live = 0;
+	unsigned i = 0;
+
+#ifndef NO_SSE
+	// Line portals need a trace per particle so those levels always take
+	// the scalar path.
+	if (!frozen && !Level->PortalBlockmap.containsLines)
+	{
+		for (; i + 4 <= count; i += 4)
 		{
-			if (particle->Pos.Z > s->GetPortalPlaneZ(sector_t::ceiling))
+			int expired = ThinkParticles4(store, i);
+			for (unsigned j = 0; j < 4; j++)
 			{
-				particle->Pos += s->GetPortalDisplacement(sector_t::ceiling);
-				particle->subsector = NULL;
+				if (!(expired & (1 << j)))
+				{
+					KeepParticle(Level, store, i + j, live++);
+				}
 			}
 		}
-		else if (!s->PortalBlocksMovement(sector_t::floor))
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		if (frozen && !store.NoTimeFreeze[i])
+		{
+			if (i != live) store.Move(i, live);
+			live++;
+		}
+		else if (ThinkParticle(Level, store, i))
 		{
-			if (particle->Pos.Z < s->GetPortalPlaneZ(sector_t::floor))
-			{
-				particle->Pos += s->GetPortalDisplacement(sector_t::floor);
-				particle->subsector = NULL;
-			}
+			KeepParticle(Level, store, i, live++);
 		}
-		prev = particle;
 	}
+	store.Count = live;
 }
 
 enum PSFlag
@@ -295,7 +473,7 @@ enum PSFlag
 void P_SpawnParticle(FLevelLocals *Level, const DVector3 &pos, const DVector3 &vel, const DVector3 &accel, PalEntry color, double startalpha, int lifetime, double size,
 	double fadestep, double sizestep, int flags)
 {
-	particle_t *particle = NewParticle(Level);
+	FNewParticle *particle = NewParticle(Level);
 
 	if (particle)
 	{
@@ -342,14 +520,14 @@ void P_RunEffects (FLevelLocals *Level)
 //
 // Creates a particle with "jitter"
 //
-particle_t *JitterParticle (FLevelLocals *Level, int ttl)
+FNewParticle *JitterParticle (FLevelLocals *Level, int ttl)
 {
 	return JitterParticle (Level, ttl, 1.0);
 }
 // [XA] Added "drift speed" multiplier setting for enhanced railgun stuffs.
-particle_t *JitterParticle (FLevelLocals *Level, int ttl, double drift)
+FNewParticle *JitterParticle (FLevelLocals *Level, int ttl, double drift)
 {
-	particle_t *particle = NewParticle (Level);
+	FNewParticle *particle = NewParticle (Level);
 
 	if (particle) {
 		int i;
@@ -370,7 +548,7 @@ particle_t *JitterParticle (FLevelLocals *Level, int ttl, double drift)
 
 static void MakeFountain (AActor *actor, int color1, int color2)
 {
-	particle_t *particle;
+	FNewParticle *particle;
 
 	if (!(actor->Level->maptime & 1))
 		return;
@@ -402,7 +580,7 @@ void P_RunEffect (AActor *actor, int effects)
 {
 	DAngle moveangle = actor->Vel.Angle();
 
-	particle_t *particle;
+	FNewParticle *particle;
 	int i;
 
 	if ((effects & FX_ROCKET) && (cl_rockettrails & 1))
@@ -432,7 +610,7 @@ void P_RunEffect (AActor *actor, int effects)
 			particle->size = 2;
 		}
 		for (i = 6; i; i--) {
-			particle_t *particle = JitterParticle (actor->Level, 3 + (M_Random() & 31));
+			FNewParticle *particle = JitterParticle (actor->Level, 3 + (M_Random() & 31));
 			if (particle) {
 				double pathdist = M_Random() / 256.;
 				DVector3 pos = actor->Vec3Offset(
@@ -525,7 +703,7 @@ void P_DrawSplash (FLevelLocals *Level, int count, const DVector3 &pos, DAngle a
 
 	for (; count; count--)
 	{
-		particle_t *p = JitterParticle (Level, 10);
+		FNewParticle *p = JitterParticle (Level, 10);
 
 		if (!p)
 			break;
@@ -574,7 +752,7 @@ void P_DrawSplash2 (FLevelLocals *Level, int count, const DVector3 &pos, DAngle
 
 	for (; count; count--)
 	{
-		particle_t *p = NewParticle (Level);
+		FNewParticle *p = NewParticle (Level);
 		DAngle an;
 
 		if (!p)
@@ -714,7 +892,7 @@ void P_DrawRailTrail(AActor *source, TArray<SPortalHit> &portalhits, int color1,
 		deg = (double)SpiralOffset;
 		for (i = spiral_steps; i; i--)
 		{
-			particle_t *p = NewParticle (source->Level);
+			FNewParticle *p = NewParticle (source->Level);
 			DVector3 tempvec;
 
 			if (!p)
@@ -785,7 +963,7 @@ void P_DrawRailTrail(AActor *source, TArray<SPortalHit> &portalhits, int color1,
 		{
 			// [XA] inner trail uses a different default duration (33).
 			int innerduration = (duration == 0) ? 33 : duration;
-			particle_t *p = JitterParticle (source->Level, innerduration, (float)drift);
+			FNewParticle *p = JitterParticle (source->Level, innerduration, (float)drift);
 
 			if (!p)
 				return;
@@ -905,7 +1083,7 @@ void P_DisconnectEffect (AActor *actor)
 
 	for (i = 64; i; i--)
 	{
-		particle_t *p = JitterParticle (actor->Level, TICRATE*2);
+		FNewParticle *p = JitterParticle (actor->Level, TICRATE*2);
 
 		if (!p)
 			break;
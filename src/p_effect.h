@@ -34,6 +34,7 @@
 #pragma once
 
 #include "vectors.h"
+#include "tarray.h"
 
 #define FX_ROCKET			0x00000001
 #define FX_GRENADE			0x00000002
@@ -44,25 +45,73 @@ struct subsector_t;
 
 // [RH] Particle details
 
+// A particle as the renderers see it. P_FindParticleSubsectors copies
+// these out of the level's particle store once per frame and chains them
+// per subsector through snext.
 struct particle_t
+{
+	DVector3 Pos;
+	DVector3 Vel;
+	double	size;
+	subsector_t * subsector;
+	float	alpha;
+	int		color;
+	uint8_t	bright;
+	uint32_t	snext;
+};
+
+const uint32_t NO_PARTICLE = 0xffffffff;
+const int MAX_PARTICLES = 1 << 20;	// Upper limit for r_maxparticles
+
+// A particle that is still being set up by the effect code. The pointer
+// returned by JitterParticle is only valid until the next particle gets
+// created.
+struct FNewParticle
 {
 	DVector3 Pos;
 	DVector3 Vel;
 	DVector3 Acc;
 	double	size;
 	double	sizestep;
-	subsector_t * subsector;
 	int32_t	ttl;
 	uint8_t	bright;
 	bool	notimefreeze;
 	float	fadestep;
 	float	alpha;
 	int		color;
-	uint16_t	tnext;
-	uint16_t	snext;
 };
 
-const uint16_t NO_PARTICLE = 0xffff;
+// Structure-of-arrays storage for the particles a level simulates. The
+// live particles are always packed into [0, Count) so that they can be
+// updated several at a time. Expired particles get removed by moving the
+// ones behind them down, which keeps the order they were spawned in.
+// Positions stay in double precision because the tiny drift velocities of
+// jittered particles would get lost in a float far from the map's origin.
+struct FParticleStore
+{
+	unsigned Count = 0;
+	unsigned Capacity = 0;
+
+	TArray<double> PosX, PosY, PosZ;
+	TArray<float> VelX, VelY, VelZ;
+	TArray<float> AccX, AccY, AccZ;
+	TArray<float> Size, SizeStep;
+	TArray<float> Alpha, FadeStep;
+	TArray<int32_t> TTL;
+	TArray<int> Color;
+	TArray<uint8_t> Bright;
+	TArray<uint8_t> NoTimeFreeze;
+	TArray<subsector_t *> Subsector;
+
+	TArray<FNewParticle> NewParticles;
+
+	void Init(unsigned capacity);
+	void Clear();
+	FNewParticle *NewParticle();
+	void AddNewParticles();
+	void Move(unsigned from, unsigned to);
+	size_t MemorySize() const;
+};
 
 void P_InitParticles(FLevelLocals *);
 void P_ClearParticles (FLevelLocals *Level);
@@ -71,8 +120,8 @@ void P_FindParticleSubsectors (FLevelLocals *Level);
 
 class AActor;
 
-particle_t *JitterParticle (FLevelLocals *Level, int ttl);
-particle_t *JitterParticle (FLevelLocals *Level, int ttl, double drift);
+FNewParticle *JitterParticle (FLevelLocals *Level, int ttl);
+FNewParticle *JitterParticle (FLevelLocals *Level, int ttl, double drift);
 
 void P_ThinkParticles (FLevelLocals *Level);
 void P_SpawnParticle(FLevelLocals *Level, const DVector3 &pos, const DVector3 &vel, const DVector3 &accel, PalEntry color, double startalpha, int lifetime, double size, double fadestep, double sizestep, int flags = 0);
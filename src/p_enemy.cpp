@@ -149,26 +149,113 @@ static void NoiseMarkSector(sector_t *sec, AActor *soundtarget, bool splash, AAc
 	NoiseList.Push({ sec, soundblocks });
 }
 
+//----------------------------------------------------------------------------
+//
+// The sound graph lists the lines of each sector that sound can pass:
+// two-sided lines to another sector and line portals. It is built on the
+// first alert after the map or a savegame got loaded.
+//
+//----------------------------------------------------------------------------
+
+static void BuildSoundGraph(FLevelLocals *Level)
+{
+	auto &graph = Level->SoundGraph;
+	graph.Sectors.Resize(Level->sectors.Size());
+	graph.Edges.Clear();
+	graph.Alert = 0;
+
+	for (auto &sec : Level->sectors)
+	{
+		auto &node = graph.Sectors[sec.Index()];
+		node.floorplane = sec.floorplane;
+		node.ceilingplane = sec.ceilingplane;
+		node.PlaneChanges = 0;
+		node.CheckedAlert = 0;
+		node.FirstEdge = graph.Edges.Size();
+
+		for (auto check : sec.Lines)
+		{
+			sector_t *other = nullptr;
+			if (check->sidedef[1] != NULL && check->sidedef[0]->sector != check->sidedef[1]->sector)
+			{
+				other = check->sidedef[0]->sector == &sec ? check->sidedef[1]->sector : check->sidedef[0]->sector;
+			}
+			if (other != nullptr || check->getPortal() != nullptr)
+			{
+				graph.Edges.Push({ check, other, ~0u, false });
+			}
+		}
+		node.NumEdges = graph.Edges.Size() - node.FirstEdge;
+	}
+}
+
+// Counts how often a sector's planes have moved. Each sector is only
+// compared once per alert.
+static unsigned SoundPlaneChanges(FSoundGraph &graph, sector_t *sec)
+{
+	auto &node = graph.Sectors[sec->Index()];
+	if (node.CheckedAlert != graph.Alert)
+	{
+		node.CheckedAlert = graph.Alert;
+		if (node.floorplane != sec->floorplane || node.ceilingplane != sec->ceilingplane)
+		{
+			node.floorplane = sec->floorplane;
+			node.ceilingplane = sec->ceilingplane;
+			node.PlaneChanges++;
+		}
+	}
+	return node.PlaneChanges;
+}
+
+static bool SoundLineClosed(line_t *check, sector_t *sec, sector_t *other)
+{
+	// check for closed door
+	return (sec->floorplane.ZatPoint(check->v1->fPos()) >=
+		other->ceilingplane.ZatPoint(check->v1->fPos()) &&
+		sec->floorplane.ZatPoint(check->v2->fPos()) >=
+		other->ceilingplane.ZatPoint(check->v2->fPos()))
+		|| (other->floorplane.ZatPoint(check->v1->fPos()) >=
+			sec->ceilingplane.ZatPoint(check->v1->fPos()) &&
+			other->floorplane.ZatPoint(check->v2->fPos()) >=
+			sec->ceilingplane.ZatPoint(check->v2->fPos()))
+		|| (other->floorplane.ZatPoint(check->v1->fPos()) >=
+			other->ceilingplane.ZatPoint(check->v1->fPos()) &&
+			other->floorplane.ZatPoint(check->v2->fPos()) >=
+			other->ceilingplane.ZatPoint(check->v2->fPos()));
+}
 
 static void P_RecursiveSound(sector_t *sec, AActor *soundtarget, bool splash, AActor *emitter, int soundblocks, double maxdist)
 {
+	auto &graph = sec->Level->SoundGraph;
 	bool checkabove = !sec->PortalBlocksSound(sector_t::ceiling);
 	bool checkbelow = !sec->PortalBlocksSound(sector_t::floor);
 
-	for (auto check : sec->Lines)
+	if (checkabove || checkbelow)
 	{
-		// check sector portals
-		// I wish there was a better method to do this than randomly looking through the portal at a few places...
-		if (checkabove)
+		for (auto check : sec->Lines)
 		{
-			sector_t *upper = P_PointInSector(sec->Level, check->v1->fPos() + check->Delta() / 2 + sec->GetPortalDisplacement(sector_t::ceiling));
-			NoiseMarkSector(upper, soundtarget, splash, emitter, soundblocks, maxdist);
-		}
-		if (checkbelow)
-		{
-			sector_t *lower = P_PointInSector(sec->Level, check->v1->fPos() + check->Delta() / 2 + sec->GetPortalDisplacement(sector_t::floor));
-			NoiseMarkSector(lower, soundtarget, splash, emitter, soundblocks, maxdist);
+			// check sector portals
+			// I wish there was a better method to do this than randomly looking through the portal at a few places...
+			if (checkabove)
+			{
+				sector_t *upper = P_PointInSector(sec->Level, check->v1->fPos() + check->Delta() / 2 + sec->GetPortalDisplacement(sector_t::ceiling));
+				NoiseMarkSector(upper, soundtarget, splash, emitter, soundblocks, maxdist);
+			}
+			if (checkbelow)
+			{
+				sector_t *lower = P_PointInSector(sec->Level, check->v1->fPos() + check->Delta() / 2 + sec->GetPortalDisplacement(sector_t::floor));
+				NoiseMarkSector(lower, soundtarget, splash, emitter, soundblocks, maxdist);
+			}
 		}
+	}
+
+	auto &node = graph.Sectors[sec->Index()];
+	unsigned secchanges = SoundPlaneChanges(graph, sec);
+
+	for (unsigned i = 0; i < node.NumEdges; i++)
+	{
+		auto &edge = graph.Edges[node.FirstEdge + i];
+		line_t *check = edge.line;
 
 		// ... and line portals;
 		FLinePortal *port = check->getPortal();
@@ -180,37 +267,26 @@ static void P_RecursiveSound(sector_t *sec, AActor *soundtarget, bool splash, AA
 			}
 		}
 
-
-		if (check->sidedef[1] == NULL ||
-			!(check->flags & ML_TWOSIDED))
+		sector_t *other = edge.other;
+		if (other == nullptr || !(check->flags & ML_TWOSIDED))
 		{
 			continue;
 		}
 
-		// Early out for intra-sector lines
-		if (check->sidedef[0]->sector == check->sidedef[1]->sector) continue;
-
-		sector_t *other;
-		if (check->sidedef[0]->sector == sec)
-			other = check->sidedef[1]->sector;
+		if (check->sidedef[0]->Flags & WALLF_POLYOBJ)
+		{
+			// The vertices may have moved, which matters for sloped planes.
+			if (SoundLineClosed(check, sec, other)) continue;
+		}
 		else
-			other = check->sidedef[0]->sector;
-
-		// check for closed door
-		if ((sec->floorplane.ZatPoint(check->v1->fPos()) >=
-			other->ceilingplane.ZatPoint(check->v1->fPos()) &&
-			sec->floorplane.ZatPoint(check->v2->fPos()) >=
-			other->ceilingplane.ZatPoint(check->v2->fPos()))
-			|| (other->floorplane.ZatPoint(check->v1->fPos()) >=
-				sec->ceilingplane.ZatPoint(check->v1->fPos()) &&
-				other->floorplane.ZatPoint(check->v2->fPos()) >=
-				sec->ceilingplane.ZatPoint(check->v2->fPos()))
-			|| (other->floorplane.ZatPoint(check->v1->fPos()) >=
-				other->ceilingplane.ZatPoint(check->v1->fPos()) &&
-				other->floorplane.ZatPoint(check->v2->fPos()) >=
-				other->ceilingplane.ZatPoint(check->v2->fPos())))
 		{
-			continue;
+			unsigned changes = secchanges + SoundPlaneChanges(graph, other);
+			if (edge.PlaneChanges != changes)
+			{
+				edge.Closed = SoundLineClosed(check, sec, other);
+				edge.PlaneChanges = changes;
+			}
+			if (edge.Closed) continue;
 		}
 
 		if (check->flags & ML_SOUNDBLOCK)
@@ -245,6 +321,13 @@ void P_NoiseAlert (AActor *emitter, AActor *target, bool splash, double maxdist)
 	if (target != NULL && target->player && (target->player->cheats & CF_NOTARGET))
 		return;
 
+	auto &graph = emitter->Level->SoundGraph;
+	if (graph.Sectors.Size() != emitter->Level->sectors.Size())
+	{
+		BuildSoundGraph(emitter->Level);
+	}
+	graph.Alert++;
+
 	validcount++;
 	NoiseList.Clear();
 	NoiseMarkSector(emitter->Sector, target, splash, emitter, 0, maxdist);
@@ -1254,14 +1337,14 @@ int P_LookForMonsters (AActor *actor)
 AActor *LookForTIDInBlock (AActor *lookee, int index, void *extparams)
 {
 	FLookExParams *params = (FLookExParams *)extparams;
-	FBlockNode *block;
 	AActor *link;
 	AActor *other;
 	
 	auto Level = lookee->Level;
-	for (block = Level->blockmap.blocklinks[index]; block != NULL; block = block->NextActor)
+	auto &block = Level->blockmap.blocklinks[index];
+	for (unsigned i = block.Size(); i-- > 0; )
 	{
-		link = block->Me;
+		link = block[i].Me;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
@@ -1425,15 +1508,15 @@ int P_LookForTID (AActor *actor, INTBOOL allaround, FLookExParams *params)
 
 AActor *LookForEnemiesInBlock (AActor *lookee, int index, void *extparam)
 {
-	FBlockNode *block;
 	AActor *link;
 	AActor *other;
 	FLookExParams *params = (FLookExParams *)extparam;
 	
 	auto Level = lookee->Level;
-	for (block = Level->blockmap.blocklinks[index]; block != NULL; block = block->NextActor)
+	auto &block = Level->blockmap.blocklinks[index];
+	for (unsigned i = block.Size(); i-- > 0; )
 	{
-		link = block->Me;
+		link = block[i].Me;
 
         if (!(link->flags & MF_SHOOTABLE))
 			continue;			// not shootable (observer or dead)
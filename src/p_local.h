@@ -46,6 +46,7 @@ struct line_t;
 struct sector_t;
 struct msecnode_t;
 struct portnode_t;
+struct FSecNodeCache;
 struct secplane_t;
 struct FCheckPosition;
 struct FTranslatedLineTarget;
@@ -278,6 +279,16 @@ bool	P_BounceWall (AActor *mo);
 bool	P_BounceActor (AActor *mo, AActor *BlockingMobj, bool ontop);
 int	P_CheckSight (AActor *t1, AActor *t2, int flags=0);
 
+struct FSightQuery
+{
+	AActor *Looker;
+	AActor *Target;
+	int Flags;
+	bool Result;
+};
+
+void	P_CheckSightBatch (FSightQuery *queries, unsigned count);
+
 enum ESightFlags
 {
 	SF_IGNOREVISIBILITY=1,
@@ -424,7 +435,7 @@ nodetype *P_AddSecnode(linktype *s, AActor *thing, nodetype *nextnode, nodetype
 template<class nodetype, class linktype>
 nodetype* P_DelSecnode(nodetype *, nodetype *linktype::*head);
 
-msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector_list, msecnode_t *sector_t::*seclisthead);
+msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector_list, msecnode_t *sector_t::*seclisthead, FSecNodeCache *cache = nullptr);
 double	P_GetMoveFactor(const AActor *mo, double *frictionp);	// phares  3/6/98
 double		P_GetFriction(const AActor *mo, double *frictionfactor);
 
@@ -5825,13 +5825,66 @@ int P_GetRadiusDamage(AActor *self, AActor *thing, int damage, int distance, int
 	return newdam;
 }
 
+//==========================================================================
+//
+// CanRadiusDamage
+//
+// Part of P_RadiusAttack. Checks whether an explosion may affect a thing
+// at all, before distance and sight are taken into account.
+//
+//==========================================================================
+
+static bool CanRadiusDamage(AActor *thing, AActor *bombspot, AActor *bombsource, int flags)
+{
+	// Vulnerable actors can be damaged by radius attacks even if not shootable
+	// Used to emulate MBF's vulnerability of non-missile bouncers to explosions.
+	if (!((thing->flags & MF_SHOOTABLE) || (thing->flags6 & MF6_VULNERABLE)))
+		return false;
+
+	// Boss spider and cyborg and Heretic's ep >= 2 bosses
+	// take no damage from concussion.
+	if (thing->flags3 & MF3_NORADIUSDMG && !(bombspot->flags4 & MF4_FORCERADIUSDMG))
+		return false;
+
+	if (!(flags & RADF_HURTSOURCE) && (thing == bombsource || thing == bombspot))
+	{ // don't damage the source of the explosion
+		return false;
+	}
+
+	// a much needed option: monsters that fire explosive projectiles cannot 
+	// be hurt by projectiles fired by a monster of the same type.
+	// Controlled by the DONTHARMCLASS and DONTHARMSPECIES flags.
+	if ((bombsource && !thing->player) // code common to both checks
+		&& ( // Class check first
+		((bombsource->flags4 & MF4_DONTHARMCLASS) && (thing->GetClass() == bombsource->GetClass()))
+		|| // Nigh-identical species check second
+		((bombsource->flags6 & MF6_DONTHARMSPECIES) && (thing->GetSpecies() == bombsource->GetSpecies()))
+		)
+		)	return false;
+
+	return true;
+}
+
 //==========================================================================
 //
 // P_RadiusAttack
 // Source is the creature that caused the explosion at spot.
 //
+// Damaging a thing can run scripts (death specials, DamageMobj and Die
+// overrides, event handlers) that move things, spawn new ones or change
+// the map, so the blockmap has to be walked lazily and each sight check
+// has to be done right before the thing it is for gets hurt. Explosions
+// that only thrust cannot run any scripts, so for them all sight checks
+// are resolved up front in one P_CheckSightBatch call.
+//
 //==========================================================================
 
+struct FRadiusCandidate
+{
+	AActor *thing;
+	int sight;		// index into the sight queries or -1 if none was needed
+};
+
 int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bombdistance, FName bombmod,
 	int flags, int fulldamagedistance)
 {
@@ -5850,36 +5903,19 @@ int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bom
 
 	P_GeometryRadiusAttack(bombspot, bombsource, bombdamage, bombdistance, bombmod, fulldamagedistance);
 
-	int count = 0;
-	while ((it.Next(&cres)))
+	auto candamage = [=](double points)
 	{
-		AActor *thing = cres.thing;
-		// Vulnerable actors can be damaged by radius attacks even if not shootable
-		// Used to emulate MBF's vulnerability of non-missile bouncers to explosions.
-		if (!((thing->flags & MF_SHOOTABLE) || (thing->flags6 & MF6_VULNERABLE)))
-			continue;
-
-		// Boss spider and cyborg and Heretic's ep >= 2 bosses
-		// take no damage from concussion.
-		if (thing->flags3 & MF3_NORADIUSDMG && !(bombspot->flags4 & MF4_FORCERADIUSDMG))
-			continue;
-
-		if (!(flags & RADF_HURTSOURCE) && (thing == bombsource || thing == bombspot))
-		{ // don't damage the source of the explosion
-			continue;
-		}
+		double check = int(points) * bombdamage;
+		// points and bombdamage should be the same sign (the double cast of 'points' is needed to prevent overflows and incorrect values slipping through.)
+		return check > 0 || (check == 0 && bombspot->flags7 & MF7_FORCEZERORADIUSDMG);
+	};
 
-		// a much needed option: monsters that fire explosive projectiles cannot 
-		// be hurt by projectiles fired by a monster of the same type.
-		// Controlled by the DONTHARMCLASS and DONTHARMSPECIES flags.
-		if ((bombsource && !thing->player) // code common to both checks
-			&& ( // Class check first
-			((bombsource->flags4 & MF4_DONTHARMCLASS) && (thing->GetClass() == bombsource->GetClass()))
-			|| // Nigh-identical species check second
-			((bombsource->flags6 & MF6_DONTHARMSPECIES) && (thing->GetSpecies() == bombsource->GetSpecies()))
-			)
-			)	continue;
+	int count = 0;
 
+	// insight is the result of a batched sight check, if it is negative
+	// the check is done here.
+	auto hitthing = [&](AActor *thing, int insight)
+	{
 		// Barrels always use the original code, since this makes
 		// them far too "active." BossBrains also use the old code
 		// because some user levels require they have a height of 16,
@@ -5887,9 +5923,7 @@ int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bom
 		if (((flags & RADF_NODAMAGE) || !((bombspot->flags5 | thing->flags5) & MF5_OLDRADIUSDMG)) && !(flags & RADF_OLDRADIUSDAMAGE))
 		{
 			double points = GetRadiusDamage(false, bombspot, thing, bombdamage, bombdistance, fulldamagedistance, bombsource == thing);
-			double check = int(points) * bombdamage;
-			// points and bombdamage should be the same sign (the double cast of 'points' is needed to prevent overflows and incorrect values slipping through.)
-			if ((check > 0 || (check == 0 && bombspot->flags7 & MF7_FORCEZERORADIUSDMG)) && P_CheckSight(thing, bombspot, SF_IGNOREVISIBILITY | SF_IGNOREWATERBOUNDARY))
+			if (candamage(points) && (insight >= 0 ? insight > 0 : P_CheckSight(thing, bombspot, SF_IGNOREVISIBILITY | SF_IGNOREWATERBOUNDARY)))
 			{ // OK to damage; target is in direct path
 				double vz;
 				double thrust;
@@ -5947,7 +5981,7 @@ int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bom
 			int damage = GetOldRadiusDamage(false, bombspot, thing, bombdamage, bombdistance, fulldamagedistance);
 
 			if (damage < 0)
-				continue;		// Sight check failed.
+				return;		// Sight check failed.
 			else if (damage > 0 || (bombspot->flags7 & MF7_FORCEZERORADIUSDMG))
 			{ // OK to damage; target is in direct path
 				//[MC] Don't count actors saved by buddha if already at 1 health.
@@ -5957,6 +5991,46 @@ int P_RadiusAttack(AActor *bombspot, AActor *bombsource, int bombdamage, int bom
 				if (thing->health < prehealth)	count++;
 			}
 		}
+	};
+
+	if (!(flags & RADF_NODAMAGE))
+	{
+		while ((it.Next(&cres)))
+		{
+			AActor *thing = cres.thing;
+			if (CanRadiusDamage(thing, bombspot, bombsource, flags))
+				hitthing(thing, -1);
+		}
+		return count;
+	}
+
+	// Thrust only changes velocities, which neither sight nor the blockmap
+	// depend on, so all things can be collected before any of them is hit.
+	TArray<FRadiusCandidate> candidates;
+	TArray<FSightQuery> sightqueries;
+
+	while ((it.Next(&cres)))
+	{
+		AActor *thing = cres.thing;
+		if (!CanRadiusDamage(thing, bombspot, bombsource, flags))
+			continue;
+
+		int sight = -1;
+		if (candamage(GetRadiusDamage(false, bombspot, thing, bombdamage, bombdistance, fulldamagedistance, bombsource == thing)))
+		{
+			sight = sightqueries.Push({ thing, bombspot, SF_IGNOREVISIBILITY | SF_IGNOREWATERBOUNDARY, false });
+		}
+		candidates.Push({ thing, sight });
+	}
+
+	if (sightqueries.Size() > 0)
+	{
+		P_CheckSightBatch(&sightqueries[0], sightqueries.Size());
+	}
+
+	for (auto &cand : candidates)
+	{
+		hitthing(cand.thing, cand.sight >= 0 ? sightqueries[cand.sight].Result : 0);
 	}
 	return count;
 }
@@ -317,6 +317,8 @@ void AActor::UnlinkFromWorld (FLinkContext *ctx)
 			{
 				P_DelSeclist(touching_sectorlist, &sector_t::touching_thinglist);
 				P_DelSeclist(touching_rendersectors, &sector_t::touching_renderthings);
+				SectorListCache.Clear();
+				RenderListCache.Clear();
 			}
 			touching_sectorlist = nullptr; //to be restored by P_SetThingPosition
 			touching_rendersectors = nullptr;
@@ -330,11 +332,7 @@ void AActor::UnlinkFromWorld (FLinkContext *ctx)
 
 		while (block != NULL)
 		{
-			if (block->NextActor != NULL)
-			{
-				block->NextActor->PrevActor = block->PrevActor;
-			}
-			*(block->PrevActor) = block->NextActor;
+			Level->blockmap.UnlinkThing(block);
 			FBlockNode *next = block->NextBlock;
 			block->Release ();
 			block = next;
@@ -489,12 +487,13 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 		// When a node is deleted, its sector links (the links starting
 		// at sector_t->touching_thinglist) are broken. When a node is
 		// added, new sector links are created.
-		touching_sectorlist = P_CreateSecNodeList(this, radius, ctx != nullptr? ctx->sector_list : nullptr, &sector_t::touching_thinglist);	// Attach to thing
-		if (renderradius >= 0) touching_rendersectors = P_CreateSecNodeList(this, MAX(radius, renderradius), ctx != nullptr ? ctx->render_list : nullptr, &sector_t::touching_renderthings);
+		touching_sectorlist = P_CreateSecNodeList(this, radius, ctx != nullptr? ctx->sector_list : nullptr, &sector_t::touching_thinglist, &SectorListCache);	// Attach to thing
+		if (renderradius >= 0) touching_rendersectors = P_CreateSecNodeList(this, MAX(radius, renderradius), ctx != nullptr ? ctx->render_list : nullptr, &sector_t::touching_renderthings, &RenderListCache);
 		else
 		{
 			touching_rendersectors = nullptr;
 			if (ctx != nullptr) P_DelSeclist(ctx->render_list, &sector_t::touching_renderthings);
+			RenderListCache.Clear();
 		}
 	}
 
@@ -530,19 +529,12 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 				{
 					for (int x = x1; x <= x2; ++x)
 					{
-						FBlockNode **link = &Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
 						FBlockNode *node = FBlockNode::Create(this, x, y, this->Sector->PortalGroup);
 
 						// Link in to block
-						if ((node->NextActor = *link) != NULL)
-						{
-							(*link)->PrevActor = &node->NextActor;
-						}
-						node->PrevActor = link;
-						*link = node;
+						Level->blockmap.LinkThing(node);
 
 						// Link in to actor
-						node->PrevBlock = alink;
 						node->NextBlock = NULL;
 						(*alink) = node;
 						alink = &node->NextBlock;
@@ -881,17 +873,22 @@ void FMultiBlockLinesIterator::Reset()
 //
 //===========================================================================
 
+// Each set bit is a BlockStamps slot that is in use by an iterator.
+static unsigned UsedBlockStamps;
+static uint64_t BlockStampGeneration;
+
 FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *l)
-: Level(l), DynHash(0)
+: Level(l), StampSlot(-1), DynHash(0)
 {
 	minx = maxx = 0;
 	miny = maxy = 0;
 	ClearHash();
 	block = NULL;
+	blockpos = 0;
 }
 
 FBlockThingsIterator::FBlockThingsIterator(FLevelLocals *L, int _minx, int _miny, int _maxx, int _maxy)
-: Level(L), DynHash(0)
+: Level(L), StampSlot(-1), DynHash(0)
 {
 	minx = _minx;
 	maxx = _maxx;
@@ -919,9 +916,106 @@ void FBlockThingsIterator::init(const FBoundingBox &box)
 
 void FBlockThingsIterator::ClearHash()
 {
-	memset(Buckets, -1, sizeof(Buckets));
-	NumFixedHash = 0;
-	DynHash.Clear();
+	if (StampSlot < 0)
+	{
+		for (unsigned i = 0; i < countof(AActor::BlockStamps); i++)
+		{
+			if (!(UsedBlockStamps & (1u << i)))
+			{
+				UsedBlockStamps |= 1u << i;
+				StampSlot = i;
+				break;
+			}
+		}
+	}
+	if (StampSlot >= 0)
+	{
+		// The generation is shared by all slots so a stamp never gets reused.
+		Stamp = ++BlockStampGeneration;
+	}
+	else
+	{
+		memset(Buckets, -1, sizeof(Buckets));
+		NumFixedHash = 0;
+		DynHash.Clear();
+	}
+}
+
+//===========================================================================
+//
+// FBlockThingsIterator :: ReleaseStampSlot
+//
+//===========================================================================
+
+void FBlockThingsIterator::ReleaseStampSlot()
+{
+	if (StampSlot >= 0)
+	{
+		UsedBlockStamps &= ~(1u << StampSlot);
+		StampSlot = -1;
+	}
+}
+
+//===========================================================================
+//
+// FBlockThingsIterator :: WasReturned
+//
+//===========================================================================
+
+bool FBlockThingsIterator::WasReturned(AActor *me)
+{
+	if (StampSlot >= 0)
+	{
+		return me->BlockStamps[StampSlot] == Stamp;
+	}
+
+	size_t hash = ((size_t)me >> 3) % countof(Buckets);
+	for (int i = Buckets[hash]; i >= 0; )
+	{
+		HashEntry *entry = GetHashEntry(i);
+		if (entry->Actor == me)
+		{
+			return true;
+		}
+		i = entry->Next;
+	}
+	return false;
+}
+
+//===========================================================================
+//
+// FBlockThingsIterator :: SetReturned
+//
+//===========================================================================
+
+void FBlockThingsIterator::SetReturned(AActor *me)
+{
+	if (StampSlot >= 0)
+	{
+		me->BlockStamps[StampSlot] = Stamp;
+		return;
+	}
+
+	size_t hash = ((size_t)me >> 3) % countof(Buckets);
+	HashEntry *entry;
+	if (NumFixedHash < (int)countof(FixedHash))
+	{
+		entry = &FixedHash[NumFixedHash];
+		entry->Next = Buckets[hash];
+		Buckets[hash] = NumFixedHash++;
+	}
+	else
+	{
+		if (DynHash.Size() == 0)
+		{
+			DynHash.Grow(50);
+		}
+		int i = DynHash.Reserve(1);
+		entry = &DynHash[i];
+		entry->Next = Buckets[hash];
+		Buckets[hash] = i + countof(FixedHash);
+	}
+	entry->Actor = me;
 }
 
 //===========================================================================
@@ -936,12 +1030,14 @@ void FBlockThingsIterator::StartBlock(int x, int y)
 	cury = y;
 	if (Level->blockmap.isValidBlock(x, y))
 	{
-		block = Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
+		block = &Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
+		blockpos = block->Size();
 	}
 	else
 	{
 		// invalid block
 		block = NULL;
+		blockpos = 0;
 	}
 }
 
@@ -962,26 +1058,29 @@ void FBlockThingsIterator::SwitchBlock(int x, int y)
 //
 // FBlockThingsIterator :: Next
 //
+// Blocks are walked from the back so that actors which get linked in
+// while iterating are skipped. Unlinking an actor below the current
+// position moves the following ones down by one, so an actor may be seen
+// again, which is why every returned actor gets marked.
+//
 //===========================================================================
 
 AActor *FBlockThingsIterator::Next(bool centeronly)
 {
 	for (;;)
 	{
-		while (block != NULL)
+		while (block != NULL && (blockpos = MIN(blockpos, block->Size())) > 0)
 		{
-			AActor *me = block->Me;
-			FBlockNode *mynode = block;
-			HashEntry *entry;
-			int i;
+			FBlockLink &link = (*block)[--blockpos];
+			AActor *me = link.Me;
 
-			block = block->NextActor;
 			// Don't recheck things that were already checked
-			if (mynode->NextBlock == NULL && mynode->PrevBlock == &me->BlockNode)
-			{ // This actor doesn't span blocks, so we know it can only ever be checked once.
-				return me;
+			if (WasReturned(me))
+			{
+				continue;
 			}
-			if (centeronly)
+			// An actor that doesn't span blocks is always returned.
+			if (centeronly && (link.Node->NextBlock != NULL || me->BlockNode != link.Node))
 			{
 				// Block boundaries for compatibility mode
 				double blockleft = (curx * FBlockmap::MAPBLOCKUNITS) + Level->blockmap.bmaporgx;
@@ -990,47 +1089,14 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 				double blocktop = blockbottom + FBlockmap::MAPBLOCKUNITS;
 
 				// only return actors with the center in this block
-				if (me->X() >= blockleft && me->X() < blockright &&
-					me->Y() >= blockbottom && me->Y() < blocktop)
-				{
-					return me;
-				}
-			}
-			else
-			{
-				size_t hash = ((size_t)me >> 3) % countof(Buckets);
-				for (i = Buckets[hash]; i >= 0; )
+				if (me->X() < blockleft || me->X() >= blockright ||
+					me->Y() < blockbottom || me->Y() >= blocktop)
 				{
-					entry = GetHashEntry(i);
-					if (entry->Actor == me)
-					{ // I've already been checked. Skip to the next actor.
-						break;
-					}
-					i = entry->Next;
-				}
-				if (i < 0)
-				{ // Add me to the hash table and return me.
-					if (NumFixedHash < (int)countof(FixedHash))
-					{
-						entry = &FixedHash[NumFixedHash];
-						entry->Next = Buckets[hash];
-						Buckets[hash] = NumFixedHash++;
-					}
-					else
-					{
-						if (DynHash.Size() == 0)
-						{
-							DynHash.Grow(50);
-						}
-						i = DynHash.Reserve(1);
-						entry = &DynHash[i];
-						entry->Next = Buckets[hash];
-						Buckets[hash] = i + countof(FixedHash);
-					}
-					entry->Actor = me;
-					return me;
+					continue;
 				}
 			}
+			SetReturned(me);
+			return me;
 		}
 
 		if (++curx > maxx)
@@ -1096,6 +1162,8 @@ bool FMultiBlockThingsIterator::Next(FMultiBlockThingsIterator::CheckResult *ite
 
 	if (onlast)
 	{
+		// Iterators that are owned by scripts may stay around for a while.
+		blockIterator.ReleaseStampSlot();
 		return false;
 	}
 
@@ -1787,23 +1855,24 @@ static AActor *RoughBlockCheck (AActor *mo, int index, void *param)
 {
 	BlockCheckInfo *info = (BlockCheckInfo *)param;
 
-	FBlockNode *link;
+	auto &block = mo->Level->blockmap.blocklinks[index];
 
-	for (link = mo->Level->blockmap.blocklinks[index]; link != NULL; link = link->NextActor)
+	for (unsigned i = block.Size(); i-- > 0; )
 	{
-		if (link->Me != mo)
+		AActor *other = block[i].Me;
+		if (other != mo)
 		{
-			if (info->onlyseekable && !mo->CanSeek(link->Me))
+			if (info->onlyseekable && !mo->CanSeek(other))
 			{
 				continue;
 			}
-			if (info->frontonly && P_PointOnDivlineSide(link->Me->X(), link->Me->Y(), &info->frontline) != 0)
+			if (info->frontonly && P_PointOnDivlineSide(other->X(), other->Y(), &info->frontline) != 0)
 			{
 				continue;
 			}
-			if (mo->IsOkayToAttack (link->Me))
+			if (mo->IsOkayToAttack (other))
 			{
-				return link->Me;
+				return other;
 			}
 		}
 	}
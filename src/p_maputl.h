@@ -284,7 +284,14 @@ class FBlockThingsIterator
 
 	int curx, cury;
 
-	FBlockNode *block;
+	TArray<FBlockLink> *block;
+	unsigned blockpos;
+
+	// Actors that were already returned get marked with the current stamp.
+	// Only a few iterators can do that at the same time, any others fall
+	// back to the hash table.
+	int StampSlot;
+	uint64_t Stamp;
 
 	int Buckets[32];
 
@@ -302,6 +309,9 @@ class FBlockThingsIterator
 	void StartBlock(int x, int y);
 	void SwitchBlock(int x, int y);
 	void ClearHash();
+	bool WasReturned(AActor *me);
+	void SetReturned(AActor *me);
+	void ReleaseStampSlot();
 
 	// The following is only for use in the path traverser 
 	// and therefore declared private.
@@ -312,10 +322,17 @@ class FBlockThingsIterator
 
 public:
 	FBlockThingsIterator(FLevelLocals *Level, int minx, int miny, int maxx, int maxy);
-	FBlockThingsIterator(FLevelLocals *l, const FBoundingBox &box) : Level(l)
+	FBlockThingsIterator(FLevelLocals *l, const FBoundingBox &box) : Level(l), StampSlot(-1)
 	{
 		init(box);
 	}
+	~FBlockThingsIterator()
+	{
+		ReleaseStampSlot();
+	}
+	FBlockThingsIterator(const FBlockThingsIterator &) = delete;
+	FBlockThingsIterator &operator=(const FBlockThingsIterator &) = delete;
+
 	void init(const FBoundingBox &box);
 	AActor *Next(bool centeronly = false);
 	void Reset() { StartBlock(minx, miny); }
@@ -311,6 +311,8 @@ void AActor::Serialize(FSerializer &arc)
 		A("fastchasestrafecount", FastChaseStrafeCount)
 		("master", master)
 		A("smokecounter", smokecounter)
+		A("lodperiod", LODPeriod)
+		A("lodskipped", LODSkipped)
 		("blockingmobj", BlockingMobj)
 		A("blockingline", BlockingLine)
 		A("blocking3dfloor", Blocking3DFloor)
@@ -381,6 +383,8 @@ void AActor::PostSerialize()
 {
 	touching_sectorlist = nullptr;
 	touching_rendersectors = nullptr;
+	SectorListCache.Clear();
+	RenderListCache.Clear();
 	LinkToWorld(nullptr, false, Sector);
 
 	AddToHash();
@@ -2895,47 +2899,50 @@ void P_NightmareRespawn (AActor *mobj)
 //
 // P_AddMobjToHash
 //
-// Inserts an mobj into the correct chain based on its tid.
+// Inserts an mobj into the bucket for its tid.
 // If its tid is 0, this function does nothing.
 //
 void AActor::AddToHash ()
 {
-	if (tid == 0)
+	if (tid != 0)
 	{
-		iprev = NULL;
-		inext = NULL;
-		return;
-	}
-	else
-	{
-		int hash = TIDHASH (tid);
-
-		inext = Level->TIDHash[hash];
-		iprev = &Level->TIDHash[hash];
-		Level->TIDHash[hash] = this;
-		if (inext)
-		{
-			inext->iprev = &inext;
-		}
+		auto &bucket = Level->TIDHash[tid];
+		TIDIndex = bucket.Actors.Push({ this, Level->TIDSeq++ });
 	}
 }
 
 //
 // P_RemoveMobjFromHash
 //
-// Removes an mobj from its hash chain.
+// Removes an mobj from its tid bucket. This only clears the entry and
+// compacts the bucket once at least half of it is unused. Compaction
+// keeps the order so iterators can find their place by sequence number.
 //
 void AActor::RemoveFromHash ()
 {
-	if (tid != 0 && iprev)
+	auto bucket = tid != 0 ? Level->TIDHash.CheckKey(tid) : nullptr;
+	if (bucket != nullptr && TIDIndex < bucket->Actors.Size() && bucket->Actors[TIDIndex].Actor == this)
 	{
-		*iprev = inext;
-		if (inext)
+		auto &actors = bucket->Actors;
+		actors[TIDIndex].Actor = nullptr;
+		if (++bucket->Dead == actors.Size())
 		{
-			inext->iprev = iprev;
+			Level->TIDHash.Remove(tid);
+		}
+		else if (bucket->Dead > 16 && bucket->Dead > actors.Size() / 2)
+		{
+			unsigned j = 0;
+			for (unsigned i = 0; i < actors.Size(); i++)
+			{
+				if (actors[i].Actor != nullptr)
+				{
+					actors[i].Actor->TIDIndex = j;
+					actors[j++] = actors[i];
+				}
+			}
+			actors.Resize(j);
+			bucket->Dead = 0;
 		}
-		iprev = NULL;
-		inext = NULL;
 	}
 	tid = 0;
 }
@@ -2951,16 +2958,7 @@ void AActor::RemoveFromHash ()
 
 bool FLevelLocals::IsTIDUsed(int tid)
 {
-	AActor *probe = TIDHash[tid & 127];
-	while (probe != NULL)
-	{
-		if (probe->tid == tid)
-		{
-			return true;
-		}
-		probe = probe->inext;
-	}
-	return false;
+	return tid != 0 && TIDHash.CheckKey(tid) != nullptr;
 }
 
 //==========================================================================
@@ -3469,6 +3467,82 @@ DEFINE_ACTION_FUNCTION(AActor, CheckPortalTransition)
 	return 0;
 }
 
+//==========================================================================
+//
+// AActor :: SkipLODTick
+//
+// With LEVEL3_ACTORLOD, idle monsters that are far away from all players
+// only get a full tick every 2, 4 or 8 tics, depending on the distance to
+// the nearest player. Only hostile monsters that are still in their spawn
+// state sequence count as idle. The skipped tics are taken off the state
+// duration on the next full tick, and a tic is never skipped if the state
+// would end on it, so every state change happens on the same tic as
+// without LOD. This only depends on the playsim, so demos and netgames
+// stay in sync.
+//
+//==========================================================================
+
+enum
+{
+	LOD_NEARDIST = 2048,	// closer than this always ticks
+	LOD_MAXPERIOD = 8
+};
+
+bool AActor::SkipLODTick()
+{
+	// Wandering monsters and friends without a target move through
+	// P_Move without any velocity, so only the spawn states are safe.
+	bool idle = (Level->flags3 & LEVEL3_ACTORLOD) && (flags3 & MF3_ISMONSTER) && !(flags & MF_FRIENDLY) &&
+		health > 0 && player == nullptr && target == nullptr && !(flags & MF_JUSTHIT) && Inventory == nullptr &&
+		!PoisonDurationReceived && Vel.isZero() && (Z() <= floorz || (flags & MF_NOGRAVITY)) &&
+		!(flags8 & MF8_INSCROLLSEC) && InStateSequence(state, SpawnState);
+
+	// Scrolling sectors and steep slopes move things that have no velocity
+	// of their own. That must happen every tic, so such things are not idle.
+	if (idle && (flags & MF_SOLID) && !(flags & MF_NOGRAVITY))
+	{
+		idle = P_FindFloorPlane(floorsector, PosAtZ(floorz)).fC() >= STEEPSLOPE;
+	}
+
+	// The tic on which the current state runs out always gets a full tick.
+	if (idle && LODPeriod > 1 && ((Level->maptime + SpawnOrder) & (LODPeriod - 1)) != 0 &&
+		(tics < 0 || tics - LODSkipped > 1))
+	{
+		LODSkipped++;
+		return true;
+	}
+
+	if (LODSkipped > 0)
+	{
+		// This tick will decrement the state's tics once more. The state can
+		// only be shorter than that if something outside changed it.
+		if (tics > 0)
+		{
+			tics = MAX(1, tics - LODSkipped);
+		}
+		LODSkipped = 0;
+	}
+
+	int period = 1;
+	if (idle)
+	{
+		double mindist = DBL_MAX;
+		for (int i = 0; i < MAXPLAYERS; i++)
+		{
+			if (playeringame[i] && players[i].mo != nullptr)
+			{
+				mindist = MIN(mindist, Distance2DSquared(players[i].mo));
+			}
+		}
+		for (double dist = LOD_NEARDIST; period < LOD_MAXPERIOD && mindist >= dist * dist; dist *= 2)
+		{
+			period *= 2;
+		}
+	}
+	LODPeriod = uint8_t(period);
+	return false;
+}
+
 //
 // P_MobjThinker
 //
@@ -3569,6 +3643,11 @@ void AActor::Tick ()
 			return;
 		}
 
+		if (SkipLODTick())
+		{
+			return;
+		}
+
 		if (effects & FX_ROCKET)
 		{
 			if (++smokecounter == 4)
@@ -4415,6 +4494,8 @@ AActor *AActor::StaticSpawn (FLevelLocals *Level, PClassActor *type, const DVect
 	actor->renderflags = (actor->renderflags & ~RF_FULLBRIGHT) | ActorRenderFlags::FromInt (st->GetFullbright());
 	actor->touching_sectorlist = nullptr;	// NULL head of sector list // phares 3/13/98
 	actor->touching_rendersectors = nullptr;
+	actor->SectorListCache.Clear();
+	actor->RenderListCache.Clear();
 	if (G_SkillProperty(SKILLP_FastMonsters))
 	{
 		double f = actor->FloatVar(NAME_FastSpeed);
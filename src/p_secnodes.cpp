@@ -36,7 +36,8 @@
 //=============================================================================
 
 msecnode_t *headsecnode = nullptr;
-FMemArena secnodearena;
+static FMemoryAccount SecNodeMemory("Sector node lists");
+FMemArena secnodearena(10*1024, &SecNodeMemory);
 
 //=============================================================================
 //
@@ -212,6 +213,38 @@ void P_DelSeclist(portnode_t *node, portnode_t *FLinePortal::*sechead)
 }
 
 
+//=============================================================================
+//
+// SecNodeLineSlack
+//
+// How far the box may move along either axis before one of the checks
+// P_CreateSecNodeList does for this line can give a different result.
+//
+//=============================================================================
+
+static double SecNodeLineSlack(const FBoundingBox &box, const line_t *ld)
+{
+	// FBoundingBox::inRange
+	double slack = MIN(MIN(fabs(box.Right() - ld->bbox[BOXLEFT]), fabs(ld->bbox[BOXRIGHT] - box.Left())),
+		MIN(fabs(box.Top() - ld->bbox[BOXBOTTOM]), fabs(ld->bbox[BOXTOP] - box.Bottom())));
+
+	// FBoundingBox::BoxOnLineSide. Moving a corner by no more than d along
+	// each axis changes the cross product by no more than d * (|dx| + |dy|).
+	DVector2 delta = ld->Delta();
+	double scale = fabs(delta.X) + fabs(delta.Y);
+	if (scale > 0)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			double x = (i & 1) ? box.Right() : box.Left();
+			double y = (i & 2) ? box.Top() : box.Bottom();
+			double cross = (y - ld->v1->fY()) * delta.X + (ld->v1->fX() - x) * delta.Y;
+			slack = MIN(slack, fabs(cross) / scale);
+		}
+	}
+	return slack;
+}
+
 //=============================================================================
 // phares 3/14/98
 //
@@ -219,12 +252,27 @@ void P_DelSeclist(portnode_t *node, portnode_t *FLinePortal::*sechead)
 //
 // Alters/creates the sector_list that shows what sectors the object resides in
 //
+// If a cache is passed, the list does not get checked again until the
+// thing has either left its sector or moved far enough to get near one of
+// the lines that were looked at. For monsters walking around in the open
+// this skips almost all of the work.
+//
 //=============================================================================
 
-msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector_list, msecnode_t *sector_t::*seclisthead)
+msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector_list, msecnode_t *sector_t::*seclisthead, FSecNodeCache *cache)
 {
 	msecnode_t *node;
 
+	if (cache != nullptr && sector_list != nullptr && cache->List == sector_list &&
+		cache->Sector == thing->Sector && cache->Radius == radius)
+	{
+		DVector2 move = thing->Pos().XY() - cache->Pos;
+		if (fabs(move.X) < cache->Slack && fabs(move.Y) < cache->Slack)
+		{
+			return sector_list;
+		}
+	}
+
 	// First, clear out the existing m_thing fields. As each node is
 	// added or verified as needed, m_thing will be set properly. When
 	// finished, delete all nodes where m_thing is still nullptr. These
@@ -241,8 +289,33 @@ msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector
 	FBlockLinesIterator it(thing->Level, box);
 	line_t *ld;
 
+	// Polyobjects can move their lines around and the vanilla side check is
+	// too imprecise to predict, so these never get cached. The same goes for
+	// boxes that are not entirely inside the blockmap because the iterator
+	// clamps those.
+	auto Level = thing->Level;
+	auto &bm = Level->blockmap;
+	double slack = -1;
+	if (cache != nullptr && Level->Polyobjects.Size() == 0 && !(Level->i_compatflags2 & COMPATF2_POINTONLINE) &&
+		box.Left() >= bm.bmaporgx && box.Bottom() >= bm.bmaporgy)
+	{
+		int x1 = bm.GetBlockX(box.Left());
+		int x2 = bm.GetBlockX(box.Right());
+		int y1 = bm.GetBlockY(box.Bottom());
+		int y2 = bm.GetBlockY(box.Top());
+		if (x2 < bm.bmapwidth && y2 < bm.bmapheight)
+		{
+			// Moving into another block changes the set of lines that get checked.
+			slack = MIN(MIN(box.Left() - (bm.bmaporgx + x1 * FBlockmap::MAPBLOCKUNITS), bm.bmaporgx + (x2 + 1) * FBlockmap::MAPBLOCKUNITS - box.Right()),
+				MIN(box.Bottom() - (bm.bmaporgy + y1 * FBlockmap::MAPBLOCKUNITS), bm.bmaporgy + (y2 + 1) * FBlockmap::MAPBLOCKUNITS - box.Top()));
+		}
+	}
+
 	while ((ld = it.Next()))
 	{
+		if (slack > 0)
+			slack = MIN(slack, SecNodeLineSlack(box, ld));
+
 		if (!box.inRange(ld) || box.BoxOnLineSide(ld) != -1)
 			continue;
 
@@ -287,6 +360,16 @@ msecnode_t *P_CreateSecNodeList(AActor *thing, double radius, msecnode_t *sector
 			node = node->m_tnext;
 		}
 	}
+
+	if (cache != nullptr)
+	{
+		// Leave some room for rounding errors in the checks.
+		cache->List = sector_list;
+		cache->Sector = thing->Sector;
+		cache->Pos = thing->Pos().XY();
+		cache->Radius = radius;
+		cache->Slack = slack - 1. / 16;
+	}
 	return sector_list;
 }
 
@@ -469,9 +552,7 @@ FBlockNode *FBlockNode::Create(AActor *who, int x, int y, int group)
 	}
 	block->BlockIndex = x + y * who->Level->blockmap.bmapwidth;
 	block->Me = who;
-	block->NextActor = nullptr;
-	block->PrevActor = nullptr;
-	block->PrevBlock = nullptr;
+	block->Index = 0;
 	block->NextBlock = nullptr;
 	return block;
 }
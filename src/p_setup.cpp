@@ -72,6 +72,7 @@
 #include "maploader/maploader.h"
 #include "p_acs.h"
 #include "fragglescript/t_script.h"
+#include "d_startuptimer.h"
 
 extern unsigned int R_OldBlend;
 
@@ -213,6 +214,42 @@ void P_FreeLevelData ()
 	R_FreePastViewers();
 }
 
+//==========================================================================
+//
+// Memory accounting for the map data of all loaded levels
+//
+//==========================================================================
+
+template<class T> static size_t ArrayMemory(const TArray<T> &array)
+{
+	return array.Max() * sizeof(T);
+}
+
+static size_t MeasureLevelMemory()
+{
+	size_t bytes = 0;
+	ForAllLevels([&](FLevelLocals *Level)
+	{
+		bytes += ArrayMemory(Level->vertexes) + ArrayMemory(Level->sectors) + ArrayMemory(Level->lines) + ArrayMemory(Level->sides);
+		bytes += ArrayMemory(Level->segs) + ArrayMemory(Level->subsectors) + ArrayMemory(Level->nodes);
+		bytes += ArrayMemory(Level->gamesubsectors) + ArrayMemory(Level->gamenodes);
+		bytes += ArrayMemory(Level->linebuffer) + ArrayMemory(Level->subsectorbuffer) + ArrayMemory(Level->segbuffer);
+		bytes += ArrayMemory(Level->loadsectors) + ArrayMemory(Level->loadlines) + ArrayMemory(Level->loadsides);
+		bytes += ArrayMemory(Level->rejectmatrix) + ArrayMemory(Level->sightpvs) + ArrayMemory(Level->Zones) + ArrayMemory(Level->PolyBlockMap);
+		bytes += ArrayMemory(Level->SoundGraph.Sectors) + ArrayMemory(Level->SoundGraph.Edges);
+		bytes += ArrayMemory(Level->sectorPortals) + ArrayMemory(Level->linePortals) + ArrayMemory(Level->linePortalSpans);
+		bytes += Level->ParticleStore.MemorySize() + ArrayMemory(Level->Particles) + ArrayMemory(Level->ParticlesInSubsec);
+		if (Level->blockmap.blocklinks != nullptr)
+		{
+			int count = Level->blockmap.bmapwidth * Level->blockmap.bmapheight;
+			for (int i = 0; i < count; i++) bytes += sizeof(TArray<FBlockLink>) + ArrayMemory(Level->blockmap.blocklinks[i]);
+		}
+	});
+	return bytes;
+}
+
+static FMemoryAccount LevelMemory("Level geometry", MeasureLevelMemory);
+
 //===========================================================================
 //
 // P_SetupLevel
@@ -408,6 +445,8 @@ void P_SetupLevel(FLevelLocals *Level, const char *lumpname, int position, bool
 	memcpy(&Level->loadlines[0], &Level->lines[0], Level->lines.Size() * sizeof(Level->lines[0]));
 	Level->loadsides.Resize(Level->sides.Size());
 	memcpy(&Level->loadsides[0], &Level->sides[0], Level->sides.Size() * sizeof(Level->sides[0]));
+
+	FMemoryAccount::UpdateAll();
 }
 
 //
@@ -421,7 +460,10 @@ void P_Init ()
 	P_InitEffects ();		// [RH]
 	P_InitTerrainTypes ();
 	P_InitKeyMessages ();
-	R_InitSprites ();
+	{
+		FStartupPhase phase("R_InitSprites");
+		R_InitSprites ();
+	}
 }
 
 static void P_Shutdown ()
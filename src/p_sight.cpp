@@ -33,10 +33,17 @@
 #include "b_bot.h"
 #include "p_spec.h"
 #include "vm.h"
+#include "c_cvars.h"
+#include "ctpl.h"
 
 #include "g_levellocals.h"
 #include "actorinlines.h"
 
+CUSTOM_CVAR(Int, sv_sightthreads, 0, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+{
+	if (self < 0) self = 0;
+}
+
 static FRandom pr_botchecksight ("BotCheckSight");
 static FRandom pr_checksight ("CheckSight");
 
@@ -51,8 +58,7 @@ This uses specialized forms of the maputils routines for optimized performance
 */
 
 // Performance meters
-static int sightcounts[6];
-static cycle_t SightCycles;
+cycle_t SightCycles;
 static cycle_t MaxSightCycles;
 
 enum
@@ -87,11 +93,52 @@ struct SightTask
 };
 
 
-static TArray<intercept_t> intercepts (128);
-static TArray<SightTask> portals(32);
+//==========================================================================
+//
+// FSightScratch
+//
+// Everything a sight check writes to is kept per thread so that checks can
+// run on several threads at once. The line and polyobject stamps replace
+// validcount, which is shared by the whole playsim.
+//
+//==========================================================================
+
+struct FSightScratch
+{
+	TArray<intercept_t> intercepts;
+	TArray<SightTask> portals;
+	TArray<unsigned> lineStamps;
+	TArray<unsigned> polyStamps;
+	unsigned stamp = 0;
+	int counts[6] = {};
+
+	void NewTraverse(FLevelLocals *Level)
+	{
+		if (lineStamps.Size() < Level->lines.Size())
+		{
+			lineStamps.Resize(Level->lines.Size());
+			memset(&lineStamps[0], 0, lineStamps.Size() * sizeof(unsigned));
+		}
+		if (polyStamps.Size() < Level->Polyobjects.Size())
+		{
+			polyStamps.Resize(Level->Polyobjects.Size());
+			memset(&polyStamps[0], 0, polyStamps.Size() * sizeof(unsigned));
+		}
+		if (++stamp == 0)
+		{
+			if (lineStamps.Size() > 0) memset(&lineStamps[0], 0, lineStamps.Size() * sizeof(unsigned));
+			if (polyStamps.Size() > 0) memset(&polyStamps[0], 0, polyStamps.Size() * sizeof(unsigned));
+			stamp = 1;
+		}
+	}
+};
+
+// The counters shown by 'stat sight' are the main thread's.
+static thread_local FSightScratch SightScratch;
 
 class SightCheck
 {
+	FSightScratch *Scratch;
 	FLevelLocals *Level;
 	DVector3 sightstart;
 	DVector2 sightend;
@@ -119,8 +166,9 @@ class SightCheck
 public:
 	bool P_SightPathTraverse ();
 
-	void init(AActor * t1, AActor * t2, sector_t *startsector, SightTask *task, int flags)
+	void init(FSightScratch *scratch, AActor * t1, AActor * t2, sector_t *startsector, SightTask *task, int flags)
 	{
+		Scratch = scratch;
 		Level = t1->Level;
 		sightstart = t1->PosRelative(task->portalgroup);
 		sightend = t2->PosRelative(task->portalgroup);
@@ -275,16 +323,16 @@ bool SightCheck::PTR_SightTraverse (intercept_t *in)
 
 		if (portaldir != sector_t::floor && (open.portalflags & SO_TOPBACK) && !(open.portalflags & SO_TOPFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
+			Scratch->portals.Push({ in->frac, topslope, bottomslope, sector_t::ceiling, backsec->GetOppositePortalGroup(sector_t::ceiling) });
 		}
 		if (portaldir != sector_t::ceiling && (open.portalflags & SO_BOTTOMBACK) && !(open.portalflags & SO_BOTTOMFRONT))
 		{
-			portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
+			Scratch->portals.Push({ in->frac, topslope, bottomslope, sector_t::floor, backsec->GetOppositePortalGroup(sector_t::floor) });
 		}
 	}
 	if (lport != nullptr && lport->mDestination != nullptr)
 	{
-		portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
+		Scratch->portals.Push({ in->frac, topslope, bottomslope, portaldir, lport->mDestination->frontsector->PortalGroup });
 		return false;
 	}
 
@@ -430,11 +478,12 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 {
 	divline_t dl;
 
-	if (ld->validcount == validcount)
+	unsigned &linestamp = Scratch->lineStamps[ld->Index()];
+	if (linestamp == Scratch->stamp)
 	{
 		return true;
 	}
-	ld->validcount = validcount;
+	linestamp = Scratch->stamp;
 	if (P_PointOnDivlineSide (ld->v1->fPos(), &Trace) ==
 		P_PointOnDivlineSide (ld->v2->fPos(), &Trace))
 	{
@@ -452,12 +501,12 @@ bool SightCheck::P_SightCheckLine (line_t *ld)
 		if (LineBlocksSight(ld)) return false;
 	}
 
-	sightcounts[3]++;
+	Scratch->counts[3]++;
 	// store the line for later intersection testing
 	intercept_t newintercept;
 	newintercept.isaline = true;
 	newintercept.d.line = ld;
-	intercepts.Push (newintercept);
+	Scratch->intercepts.Push (newintercept);
 
 	return true;
 }
@@ -491,9 +540,10 @@ int SightCheck::P_SightBlockLinesIterator (int x, int y)
 	{
 		if (polyLink->polyobj)
 		{ // only check non-empty links
-			if (polyLink->polyobj->validcount != validcount)
+			unsigned &polystamp = Scratch->polyStamps[unsigned(polyLink->polyobj - &Level->Polyobjects[0])];
+			if (polystamp != Scratch->stamp)
 			{
-				polyLink->polyobj->validcount = validcount;
+				polystamp = Scratch->stamp;
 				for (i = 0; i < polyLink->polyobj->Linedefs.Size(); i++)
 				{
 					if (!P_SightCheckLine(polyLink->polyobj->Linedefs[i]))
@@ -535,6 +585,7 @@ bool SightCheck::P_SightTraverseIntercepts ()
 	intercept_t *scan, *in;
 	unsigned scanpos;
 	divline_t dl;
+	auto &intercepts = Scratch->intercepts;
 
 	count = intercepts.Size ();
 //
@@ -623,8 +674,8 @@ bool SightCheck::P_SightPathTraverse ()
 	int mapx, mapy, mapxstep, mapystep;
 	int count;
 
-	validcount++;
-	intercepts.Clear ();
+	Scratch->NewTraverse(Level);
+	Scratch->intercepts.Clear ();
 	x1 = sightstart.X + Startfrac * Trace.dx;
 	y1 = sightstart.Y + Startfrac * Trace.dy;
 	x2 = sightend.X;
@@ -656,11 +707,11 @@ bool SightCheck::P_SightPathTraverse ()
 	// We also must check if the starting sector contains  portals, and start sight checks in those as well.
 	if (portaldir != sector_t::floor && checkceiling && !lastsector->PortalBlocksSight(sector_t::ceiling))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
+		Scratch->portals.Push({ 0, topslope, bottomslope, sector_t::ceiling, lastsector->GetOppositePortalGroup(sector_t::ceiling) });
 	}
 	if (portaldir != sector_t::ceiling && checkfloor && !lastsector->PortalBlocksSight(sector_t::floor))
 	{
-		portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
+		Scratch->portals.Push({ 0, topslope, bottomslope, sector_t::floor, lastsector->GetOppositePortalGroup(sector_t::floor) });
 	}
 
 	x1 -= Level->blockmap.bmaporgx;
@@ -756,7 +807,7 @@ bool SightCheck::P_SightPathTraverse ()
 		itres = P_SightBlockLinesIterator(mapx, mapy);
 		if (itres == 0)
 		{
-			sightcounts[1]++;
+			Scratch->counts[1]++;
 			return false;	// early out
 		}
 
@@ -767,7 +818,7 @@ bool SightCheck::P_SightPathTraverse ()
 		switch (((xs_FloorToInt(yintercept) == mapy) << 1) | (xs_FloorToInt(xintercept) == mapx))
 		{
 		case 0:		// neither xintercept nor yintercept match!
-sightcounts[5]++;
+Scratch->counts[5]++;
 			// Continuing won't make things any better, so we might as well stop right here
 			count = 1000;
 			break;
@@ -787,7 +838,7 @@ sightcounts[5]++;
 			break;
 
 		case 3:		// xintercept and yintercept both match
-			sightcounts[4]++;
+			Scratch->counts[4]++;
 			// The trace is exiting a block through its corner. Not only does the block
 			// being entered need to be checked (which will happen when this loop
 			// continues), but the other two blocks adjacent to the corner also need to
@@ -795,7 +846,7 @@ sightcounts[5]++;
 			if (!P_SightBlockLinesIterator (mapx + mapxstep, mapy) ||
 				!P_SightBlockLinesIterator (mapx, mapy + mapystep))
 			{
-sightcounts[1]++;
+Scratch->counts[1]++;
 				return false;
 			}
 			xintercept += xstep;
@@ -814,7 +865,7 @@ sightcounts[1]++;
 //
 // couldn't early out, so go through the sorted list
 //
-sightcounts[2]++;
+Scratch->counts[2]++;
 
 	bool traverseres = P_SightTraverseIntercepts ( );
 	if (itres == -1) return false;	// if the iterator had an early out there was no line of sight. The traverser was only called to collect more portals.
@@ -822,32 +873,19 @@ sightcounts[2]++;
 	return traverseres;
 }
 
-/*
-=====================
-=
-= P_CheckSight
-=
-= Returns true if a straight line between t1 and t2 is unobstructed
-= look from eyes of t1 to any part of t2
-=
-= killough 4/20/98: cleaned up, made to use new LOS struct
-=
-=====================
-*/
+//==========================================================================
+//
+// P_SightTrivialCheck
+//
+// Everything that can decide a sight check without tracing through the
+// map. This is also the only part that uses the random number generator,
+// so it must always run on the main thread in playsim order.
+// Returns -1 if the line of sight still needs to be traced.
+//
+//==========================================================================
 
-int P_CheckSight (AActor *t1, AActor *t2, int flags)
+static int P_SightTrivialCheck (AActor *t1, AActor *t2, int flags)
 {
-	SightCycles.Clock();
-
-	bool res;
-
-	assert (t1 != NULL);
-	assert (t2 != NULL);
-	if (t1 == NULL || t2 == NULL)
-	{
-		return false;
-	}
-
 	auto Level = t1->Level;
 	const sector_t *s1 = t1->Sector;
 	const sector_t *s2 = t2->Sector;
@@ -859,9 +897,8 @@ int P_CheckSight (AActor *t1, AActor *t2, int flags)
 	if (Level->rejectmatrix.Size() > 0 &&
 		(Level->rejectmatrix[pnum>>3] & (1 << (pnum & 7))))
 	{
-sightcounts[0]++;
-		res = false;			// can't possibly be connected
-		goto done;
+		SightScratch.counts[0]++;
+		return false;			// can't possibly be connected
 	}
 
 //
@@ -873,8 +910,7 @@ sightcounts[0]++;
 	{ // small chance of an attack being made anyway
 		if ((bglobal.m_Thinking ? pr_botchecksight() : pr_checksight()) > 50)
 		{
-			res = false;
-			goto done;
+			return false;
 		}
 	}
 
@@ -894,56 +930,214 @@ sightcounts[0]++;
 			  (t2->Z() >= s2->heightsec->ceilingplane.ZatPoint(t2) &&
 			   t1->Top() <= s2->heightsec->ceilingplane.ZatPoint(t1)))))
 		{
-			res = false;
-			goto done;
+			return false;
 		}
 	}
 
-	// An unobstructed LOS is possible.
-	// Now look from eyes of t1 to any part of t2.
+	// The generated matrix is checked last so that it cannot affect anything but the trace.
+	if (Level->sightpvs.Size() > 0 &&
+		!(Level->sightpvs[pnum>>3] & (1 << (pnum & 7))))
+	{
+		SightScratch.counts[0]++;
+		return false;
+	}
+	return -1;
+}
+
+//==========================================================================
+//
+// P_SightTrace
+//
+// An unobstructed LOS is possible.
+// Now look from eyes of t1 to any part of t2.
+// This only reads the level so it may be called from any thread.
+//
+//==========================================================================
 
-	validcount++;
+static bool P_SightTrace (FSightScratch &scratch, AActor *t1, AActor *t2, int flags)
+{
+	auto &portals = scratch.portals;
 	portals.Clear();
-	{
-		sector_t *sec;
-		double lookheight = t1->Z() + t1->Height*0.75;
-		t1->GetPortalTransition(lookheight, &sec);
 
-		double bottomslope = t2->Z() - lookheight;
-		double topslope = bottomslope + t2->Height;
-		SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
+	sector_t *sec;
+	double lookheight = t1->Z() + t1->Height*0.75;
+	t1->GetPortalTransition(lookheight, &sec);
 
+	double bottomslope = t2->Z() - lookheight;
+	double topslope = bottomslope + t2->Height;
+	SightTask task = { 0, topslope, bottomslope, -1, sec->PortalGroup };
 
-		SightCheck s;
-		s.init(t1, t2, sec, &task, flags);
-		res = s.P_SightPathTraverse ();
-		if (!res)
+	SightCheck s;
+	s.init(&scratch, t1, t2, sec, &task, flags);
+	bool res = s.P_SightPathTraverse ();
+	if (!res)
+	{
+		double dist = t1->Distance2D(t2);
+		for (unsigned i = 0; i < portals.Size(); i++)
 		{
-			double dist = t1->Distance2D(t2);
-			for (unsigned i = 0; i < portals.Size(); i++)
+			portals[i].Frac += 1 / dist;
+			s.init(&scratch, t1, t2, NULL, &portals[i], flags);
+			if (s.P_SightPathTraverse())
 			{
-				portals[i].Frac += 1 / dist;
-				s.init(t1, t2, NULL, &portals[i], flags);
-				if (s.P_SightPathTraverse())
-				{
-					res = true;
-					break;
-				}
+				res = true;
+				break;
 			}
 		}
 	}
+	return res;
+}
 
-done:
+/*
+=====================
+=
+= P_CheckSight
+=
+= Returns true if a straight line between t1 and t2 is unobstructed
+= look from eyes of t1 to any part of t2
+=
+= killough 4/20/98: cleaned up, made to use new LOS struct
+=
+=====================
+*/
+
+int P_CheckSight (AActor *t1, AActor *t2, int flags)
+{
+	assert (t1 != NULL);
+	assert (t2 != NULL);
+	if (t1 == NULL || t2 == NULL)
+	{
+		return false;
+	}
+
+	SightCycles.Clock();
+	int res = P_SightTrivialCheck(t1, t2, flags);
+	if (res < 0)
+	{
+		res = P_SightTrace(SightScratch, t1, t2, flags);
+	}
 	SightCycles.Unclock();
 	return res;
 }
 
+//==========================================================================
+//
+// P_CheckSightBatch
+//
+// Resolves many sight checks at once and gives the same results as
+// calling P_CheckSight for each query in order. The checks that need the
+// random number generator are done first on the calling thread, then the
+// remaining traces get split across sv_sightthreads worker threads.
+// The playsim must not change anything while this runs.
+//
+//==========================================================================
+
+static ctpl::thread_pool SightPool;
+
+enum
+{
+	MIN_SIGHT_BATCH = 64,	// Below this the traces are not worth handing off
+};
+
+static int SightThreadCount()
+{
+	int threads = sv_sightthreads;
+	if (threads == 0)
+	{
+		threads = clamp((int)std::thread::hardware_concurrency(), 1, 8);
+	}
+	return threads;
+}
+
+void P_CheckSightBatch (FSightQuery *queries, unsigned count)
+{
+	SightCycles.Clock();
+
+	TArray<unsigned> traces;
+	for (unsigned i = 0; i < count; i++)
+	{
+		auto &q = queries[i];
+		assert(q.Looker != NULL && q.Target != NULL);
+		if (q.Looker == NULL || q.Target == NULL)
+		{
+			q.Result = false;
+			continue;
+		}
+		int res = P_SightTrivialCheck(q.Looker, q.Target, q.Flags);
+		if (res >= 0)
+		{
+			q.Result = !!res;
+		}
+		else
+		{
+			traces.Push(i);
+		}
+	}
+
+	int threads = SightThreadCount();
+	if (threads <= 1 || traces.Size() < MIN_SIGHT_BATCH)
+	{
+		for (auto i : traces)
+		{
+			auto &q = queries[i];
+			q.Result = P_SightTrace(SightScratch, q.Looker, q.Target, q.Flags);
+		}
+	}
+	else
+	{
+		if (SightPool.size() != threads - 1)
+		{
+			SightPool.resize(threads - 1);
+		}
+
+		struct Counts { int counts[6]; };
+		TArray<Counts> chunkcounts(threads, true);
+		std::vector<std::future<void>> futures;
+
+		auto work = [&](int chunk)
+		{
+			// Each worker writes to its own queries only.
+			FSightScratch &scratch = SightScratch;
+			int saved[6];
+			memcpy(saved, scratch.counts, sizeof(saved));
+			memset(scratch.counts, 0, sizeof(scratch.counts));
+
+			unsigned start = traces.Size() * chunk / threads;
+			unsigned end = traces.Size() * (chunk + 1) / threads;
+			for (unsigned j = start; j < end; j++)
+			{
+				auto &q = queries[traces[j]];
+				q.Result = P_SightTrace(scratch, q.Looker, q.Target, q.Flags);
+			}
+
+			memcpy(chunkcounts[chunk].counts, scratch.counts, sizeof(saved));
+			memcpy(scratch.counts, saved, sizeof(saved));
+		};
+
+		for (int chunk = 1; chunk < threads; chunk++)
+		{
+			futures.push_back(SightPool.push([=](int) { work(chunk); }));
+		}
+		work(0);
+		for (auto &f : futures)
+		{
+			f.wait();
+		}
+
+		for (auto &c : chunkcounts)
+		{
+			for (int j = 0; j < 6; j++) SightScratch.counts[j] += c.counts[j];
+		}
+	}
+	SightCycles.Unclock();
+}
+
 ADD_STAT (sight)
 {
 	FString out;
+	auto &counts = SightScratch.counts;
 	out.Format ("%04.1f ms (%04.1f max), %5d %2d%4d%4d%4d%4d\n",
 		SightCycles.TimeMS(), MaxSightCycles.TimeMS(),
-		sightcounts[3], sightcounts[0], sightcounts[1], sightcounts[2], sightcounts[4], sightcounts[5]);
+		counts[3], counts[0], counts[1], counts[2], counts[4], counts[5]);
 	return out;
 }
 
@@ -958,5 +1152,5 @@ void P_ResetSightCounters (bool full)
 		MaxSightCycles = SightCycles;
 	}
 	SightCycles.Reset();
-	memset (sightcounts, 0, sizeof(sightcounts));
+	memset (SightScratch.counts, 0, sizeof(SightScratch.counts));
 }
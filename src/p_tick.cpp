@@ -37,10 +37,13 @@
 #include "g_levellocals.h"
 #include "events.h"
 #include "actorinlines.h"
+#include "stats.h"
 
 extern gamestate_t wipegamestate;
 extern bool globalfreeze;
 
+cycle_t TickerCycles;
+
 //==========================================================================
 //
 // P_CheckTickerPaused
@@ -71,9 +74,9 @@ bool P_CheckTickerPaused ()
 }
 
 //
-// P_Ticker
+// P_RunTicker
 //
-void P_Ticker (void)
+static void P_RunTicker (void)
 {
 	int i;
 
@@ -167,3 +170,15 @@ void P_Ticker (void)
 	currentSession->time++;
 	currentSession->totaltime++;
 }
+
+//
+// P_Ticker
+//
+void P_Ticker (void)
+{
+	FTraceScope trace("P_Ticker");
+	TickerCycles.Reset();
+	TickerCycles.Clock();
+	P_RunTicker();
+	TickerCycles.Unclock();
+}
@@ -1430,11 +1430,7 @@ void P_PredictPlayer (player_t *player)
 
 	while (block != NULL)
 	{
-		if (block->NextActor != NULL)
-		{
-			block->NextActor->PrevActor = block->PrevActor;
-		}
-		*(block->PrevActor) = block->NextActor;
+		act->Level->blockmap.UnlinkThing(block);
 		block = block->NextBlock;
 	}
 	act->BlockNode = NULL;
@@ -1499,6 +1495,17 @@ void P_PredictPlayer (player_t *player)
 	}
 }
 
+// The nodes need to be restored in the reverse order they were unlinked in
+// P_PredictPlayer to get the same ordering in the blocks.
+static void RestoreBlockNodes(FBlockmap &blockmap, FBlockNode *block)
+{
+	if (block != NULL)
+	{
+		RestoreBlockNodes(blockmap, block->NextBlock);
+		blockmap.RestoreThing(block);
+	}
+}
+
 void P_UnPredictPlayer ()
 {
 	player_t *player = &players[consoleplayer];
@@ -1566,20 +1573,12 @@ void P_UnPredictPlayer ()
 			act->touching_rendersectors = RestoreNodeList(act, ctx.render_list, &sector_t::touching_renderthings, PredictionRenderSectors_sprev_Backup, PredictionRenderSectorsBackup);
 			act->touching_sectorportallist = RestoreNodeList(act, sectorportal_list, &sector_t::sectorportal_thinglist, PredictionPortalSectors_sprev_Backup, PredictionPortalSectorsBackup);
 			act->touching_lineportallist = RestoreNodeList(act, lineportal_list, &FLinePortal::lineportal_thinglist, PredictionPortalLines_sprev_Backup, PredictionPortalLinesBackup);
+			act->SectorListCache.Clear();
+			act->RenderListCache.Clear();
 		}
 
-		// Now fix the pointers in the blocknode chain
-		FBlockNode *block = act->BlockNode;
-
-		while (block != NULL)
-		{
-			*(block->PrevActor) = block;
-			if (block->NextActor != NULL)
-			{
-				block->NextActor->PrevActor = &block->NextActor;
-			}
-			block = block->NextBlock;
-		}
+		// Now put the block nodes back where they were
+		RestoreBlockNodes(act->Level->blockmap, act->BlockNode);
 
 		actInvSel = InvSel;
 		player->inventorytics = inventorytics;
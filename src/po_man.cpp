@@ -1054,7 +1054,6 @@ bool FPolyObj::CheckMobjBlocking (side_t *sd)
 {
 	auto Level = GetLevel();
 	static TArray<AActor *> checker;
-	FBlockNode *block;
 	AActor *mobj;
 	int i, j, k;
 	int left, right, top, bottom;
@@ -1087,9 +1086,11 @@ bool FPolyObj::CheckMobjBlocking (side_t *sd)
 	{
 		for (i = left; i <= right; i++)
 		{
-			for (block = Level->blockmap.blocklinks[j+i]; block != nullptr; block = block->NextActor)
+			// Moving an actor below unlinks it from this block.
+			auto &block = Level->blockmap.blocklinks[j+i];
+			for (unsigned b = block.Size(); (b = MIN(b, block.Size())) > 0; )
 			{
-				mobj = block->Me;
+				mobj = block[--b].Me;
 				for (k = (int)checker.Size()-1; k >= 0; --k)
 				{
 					if (checker[k] == mobj)
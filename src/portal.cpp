@@ -434,6 +434,7 @@ void P_FinalizePortals(FLevelLocals *Level)
 	P_CollectLinkedPortals(Level);
 	BuildBlockmap(Level);
 	P_CreateLinkedPortals(Level);
+	Level->SoundGraph.Clear();	// the sound graph knows which lines are portals
 }
 
 //============================================================================
@@ -48,6 +48,7 @@
 #include "r_data/sprites.h"
 #include "vm.h"
 #include "actorinlines.h"
+#include "m_alloc.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -195,6 +196,7 @@ static void S_AddSNDINFO (int lumpnum);
 static void S_AddBloodSFX (int lumpnum);
 static void S_AddStrifeVoice (int lumpnum);
 static int S_AddSound (const char *logicalname, int lumpnum, FScanner *sc=NULL);
+static size_t MeasureSoundMemory ();
 
 // EXTERNAL DATA DECLARATIONS ----------------------------------------------
 
@@ -207,6 +209,8 @@ TMap<int, FString> HexenMusic;
 
 // PRIVATE DATA DEFINITIONS ------------------------------------------------
 
+static FMemoryAccount SoundMemory("Sounds", MeasureSoundMemory);
+
 static const char *SICommandStrings[] =
 {
 	"$ambient",
@@ -2445,3 +2449,25 @@ DEFINE_ACTION_FUNCTION(DObject, MarkSound)
 	return 0;
 }
 
+//==========================================================================
+//
+// MeasureSoundMemory
+//
+// The decoded samples are owned by the sound backend, so this only counts
+// the size of the lumps the loaded sounds were created from.
+//
+//==========================================================================
+
+static size_t MeasureSoundMemory ()
+{
+	size_t bytes = 0;
+	for (auto &sfx : S_sfx)
+	{
+		if (sfx.data.isValid() && sfx.lumpnum >= 0)
+		{
+			bytes += Wads.LumpLength(sfx.lumpnum);
+		}
+	}
+	return bytes;
+}
+
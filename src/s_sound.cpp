@@ -2162,6 +2162,7 @@ void S_RestoreEvictedChannels()
 
 void S_UpdateSounds (AActor *listenactor)
 {
+	FTraceScope trace("S_UpdateSounds");
 	FVector3 pos, vel;
 	SoundListener listener;
 
@@ -1147,6 +1147,7 @@ int FScriptPosition::ErrorCounter;
 int FScriptPosition::WarnCounter;
 bool FScriptPosition::StrictErrors;	// makes all OPTERROR messages real errors.
 bool FScriptPosition::errorout;		// call I_Error instead of printing the error itself.
+thread_local FScriptMessages *FScriptPosition::Capture;
 
 FScriptPosition::FScriptPosition(const FScriptPosition &other)
 {
@@ -1191,7 +1192,8 @@ void FScriptPosition::Message (int severity, const char *message, ...) const
 	if (severity == MSG_DEBUGMSG && developer < DMSG_NOTIFY) return;
 	if (severity == MSG_OPTERROR)
 	{
-		severity = StrictErrors || strictdecorate ? MSG_ERROR : MSG_WARNING;
+		bool strict = Capture != nullptr ? Capture->StrictErrors : StrictErrors;
+		severity = strict || strictdecorate ? MSG_ERROR : MSG_WARNING;
 	}
 	// This is mainly for catching the error with an exception handler.
 	if (severity == MSG_ERROR && errorout) severity = MSG_FATAL;
@@ -1219,13 +1221,15 @@ void FScriptPosition::Message (int severity, const char *message, ...) const
 	case MSG_WARNING:
 	case MSG_DEBUGWARN:
 	case MSG_DEBUGERROR:	// This is intentionally not being printed as an 'error', the difference to MSG_DEBUGWARN is only the severity level at which it gets triggered.
-		WarnCounter++;
+		if (Capture != nullptr) Capture->WarnCounter++;
+		else WarnCounter++;
 		type = "warning";
 		color = TEXTCOLOR_ORANGE;
 		break;
 
 	case MSG_ERROR:
-		ErrorCounter++;
+		if (Capture != nullptr) Capture->ErrorCounter++;
+		else ErrorCounter++;
 		type = "error";
 		color = TEXTCOLOR_RED;
 		break;
@@ -1248,8 +1252,37 @@ void FScriptPosition::Message (int severity, const char *message, ...) const
 			FileName.GetChars(), ScriptLine, composed.GetChars());
 		return;
 	}
+	if (Capture != nullptr)
+	{
+		FString text;
+		text.Format("%sScript %s, \"%s\" line %d:\n%s%s\n",
+			color, type, FileName.GetChars(), ScriptLine, color, composed.GetChars());
+		Capture->Messages.Push({ level, text });
+		return;
+	}
 	Printf (level, "%sScript %s, \"%s\" line %d:\n%s%s\n",
 		color, type, FileName.GetChars(), ScriptLine, color, composed.GetChars());
 }
 
+//==========================================================================
+//
+// FScriptMessages::Flush
+//
+// Prints the collected messages and adds them to the global counters.
+// Must be called on the main thread.
+//
+//==========================================================================
+
+void FScriptMessages::Flush()
+{
+	for (auto &msg : Messages)
+	{
+		Printf(msg.PrintLevel, "%s", msg.Text.GetChars());
+	}
+	Messages.Clear();
+	FScriptPosition::WarnCounter += WarnCounter;
+	FScriptPosition::ErrorCounter += ErrorCounter;
+	WarnCounter = ErrorCounter = 0;
+}
+
 
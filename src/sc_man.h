@@ -152,6 +152,29 @@ enum
 	MSG_MESSAGE
 };
 
+//==========================================================================
+//
+// Collects the messages of a compile step that runs on a worker thread
+// so they can be printed in order once it is done.
+//
+//==========================================================================
+
+struct FScriptMessages
+{
+	struct Entry
+	{
+		int PrintLevel;
+		FString Text;
+	};
+
+	TArray<Entry> Messages;
+	int WarnCounter = 0;
+	int ErrorCounter = 0;
+	bool StrictErrors = false;
+
+	void Flush();
+};
+
 //==========================================================================
 //
 // a class that remembers a parser position
@@ -164,6 +187,7 @@ struct FScriptPosition
 	static int ErrorCounter;
 	static bool StrictErrors;
 	static bool errorout;
+	static thread_local FScriptMessages *Capture;	// if set, messages from this thread go here
 	FName FileName;
 	int ScriptLine;
 
@@ -50,7 +50,8 @@
 #include "g_levellocals.h"
 
 extern FRandom pr_exrandom;
-FMemArena FxAlloc(65536);
+FMemoryAccount ZScriptMemory("ZScript compiler");
+FMemArena FxAlloc(65536, &ZScriptMemory);
 int utf8_decode(const char *src, int *size);
 
 struct FLOP
@@ -563,7 +564,7 @@ ExpEmit FxConstant::Emit(VMFunctionBuilder *build)
 	}
 	else if (regtype == REGT_STRING)
 	{
-		out.RegNum = build->GetConstantString(value.GetString());
+		out.RegNum = build->GetConstantString(value.GetStringCopy());
 	}
 	else
 	{
@@ -11374,7 +11375,7 @@ ExpEmit FxLocalVariableDeclaration::Emit(VMFunctionBuilder *build)
 					break;
 				}
 				case REGT_STRING:
-					build->Emit(OP_LKS, RegNum, build->GetConstantString(constval->GetValue().GetString()));
+					build->Emit(OP_LKS, RegNum, build->GetConstantString(constval->GetStringCopy()));
 				}
 				emitval.Free(build);
 			}
@@ -11502,7 +11503,7 @@ ExpEmit FxStaticArray::Emit(VMFunctionBuilder *build)
 	case REGT_STRING:
 	{
 		TArray<FString> cvalues;
-		for (auto v : values) cvalues.Push(static_cast<FxConstant *>(v)->GetValue().GetString());
+		for (auto v : values) cvalues.Push(static_cast<FxConstant *>(v)->GetStringCopy());
 		StackOffset = build->AllocConstantsString(cvalues.Size(), &cvalues[0]);
 		break;
 	}
@@ -11651,7 +11652,7 @@ ExpEmit FxLocalArrayDeclaration::Emit(VMFunctionBuilder *build)
 				break;
 
 			case REGT_STRING:
-				build->Emit(OP_LKS, regNum, build->GetConstantString(constval->GetValue().GetString()));
+				build->Emit(OP_LKS, regNum, build->GetConstantString(constval->GetStringCopy()));
 				build->Emit(OP_SS_R, build->FramePointer.RegNum, regNum, arrOffsetReg);
 				break;
 			}
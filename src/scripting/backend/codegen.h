@@ -60,6 +60,7 @@
 class VMFunctionBuilder;
 class FxJumpStatement;
 
+extern FMemoryAccount ZScriptMemory;
 extern FMemArena FxAlloc;
 
 //==========================================================================
@@ -200,6 +201,15 @@ struct ExpVal
 		return Type == TypeString ? *(FString *)&pointer : Type == TypeName ? FString(FName(ENamedName(Int)).GetChars()) : "";
 	}
 
+	// Unlike GetString this does not share the string's buffer, because the
+	// code generator can emit several functions on different threads.
+	FString GetStringCopy() const
+	{
+		if (Type != TypeString) return GetString();
+		auto str = (const FString *)&pointer;
+		return FString(str->GetChars(), str->Len());
+	}
+
 	bool GetBool() const
 	{
 		int regtype = Type->GetRegType();
@@ -551,6 +561,10 @@ public:
 	{
 		return value;
 	}
+	FString GetStringCopy() const
+	{
+		return value.GetStringCopy();
+	}
 	ExpEmit Emit(VMFunctionBuilder *build);
 };
 
@@ -37,6 +37,9 @@
 #include "m_argv.h"
 #include "c_cvars.h"
 #include "scripting/vm/jit.h"
+#include "ctpl.h"
+#include <atomic>
+#include <mutex>
 
 struct VMRemap
 {
@@ -50,6 +53,9 @@ VMRemap opRemap[NUM_OPS] = {
 };
 #undef xx
 
+// ClassDataAllocator is shared by all code generation threads.
+static std::mutex ArenaMutex;
+
 //==========================================================================
 //
 // VMFunctionBuilder - Constructor
@@ -109,7 +115,10 @@ void VMFunctionBuilder::EndStatement()
 
 void VMFunctionBuilder::MakeFunction(VMScriptFunction *func)
 {
-	func->Alloc(Code.Size(), IntConstantList.Size(), FloatConstantList.Size(), StringConstantList.Size(), AddressConstantList.Size(), LineNumbers.Size());
+	{
+		std::lock_guard<std::mutex> lock(ArenaMutex);
+		func->Alloc(Code.Size(), IntConstantList.Size(), FloatConstantList.Size(), StringConstantList.Size(), AddressConstantList.Size(), LineNumbers.Size());
+	}
 
 	// Copy code block.
 	memcpy(func->Code, &Code[0], Code.Size() * sizeof(VMOP));
@@ -803,6 +812,35 @@ VMFunction *FFunctionBuildList::AddFunction(PNamespace *gnspc, const VersionInfo
 }
 
 
+//==========================================================================
+//
+// FFunctionBuildList :: Build
+//
+// Resolving has to be done in order because it creates types and symbols
+// that later functions may depend on. Emitting the code only depends on
+// the function itself so that part gets spread across vm_codegen_threads
+// worker threads. The result is the same as emitting everything in order,
+// including the messages that get printed.
+//
+//==========================================================================
+
+CVAR(Int, vm_codegen_threads, 0, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// 0 uses all cores
+
+enum
+{
+	MIN_CODEGEN_BATCH = 256,	// Below this the threads are not worth starting
+};
+
+struct FEmitJob
+{
+	VMFunctionBuilder *Builder = nullptr;
+	FScriptMessages Messages;
+	std::exception_ptr Error;
+	bool Unsafe = false;
+	bool Emitted = false;
+	bool Skipped = false;
+};
+
 void FFunctionBuildList::Build()
 {
 	int codesize = 0;
@@ -811,15 +849,19 @@ void FFunctionBuildList::Build()
 
 	if (Args->CheckParm("-dumpdisasm")) dump = fopen("disasm.txt", "w");
 
-	for (auto &item : mItems)
+	std::vector<FEmitJob> jobs(mItems.Size());
+
+	for (unsigned i = 0; i < mItems.Size(); i++)
 	{
+		auto &item = mItems[i];
+		auto &job = jobs[i];
 		assert(item.Code != NULL);
 
 		// We don't know the return type in advance for anonymous functions.
 		FCompileContext ctx(item.CurGlobals, item.Func, item.Func->SymbolName == NAME_None ? nullptr : item.Func->Variants[0].Proto, item.FromDecorate, item.StateIndex, item.StateCount, item.Lump, item.Version);
 
 		// Allocate registers for the function's arguments and create local variable nodes before starting to resolve it.
-		VMFunctionBuilder buildit(item.Func->GetImplicitArgs());
+		auto buildit = new VMFunctionBuilder(item.Func->GetImplicitArgs());
 		for (unsigned i = 0; i < item.Func->Variants[0].Proto->ArgumentTypes.Size(); i++)
 		{
 			auto type = item.Func->Variants[0].Proto->ArgumentTypes[i];
@@ -827,8 +869,8 @@ void FFunctionBuildList::Build()
 			auto flags = item.Func->Variants[0].ArgFlags[i];
 			// this won't get resolved and won't get emitted. It is only needed so that the code generator can retrieve the necessary info about this argument to do its work.
 			auto local = new FxLocalVariableDeclaration(type, name, nullptr, flags, FScriptPosition());
-			if (!(flags & VARF_Out)) local->RegNum = buildit.Registers[type->GetRegType()].Get(type->GetRegCount());
-			else local->RegNum = buildit.Registers[REGT_POINTER].Get(1);
+			if (!(flags & VARF_Out)) local->RegNum = buildit->Registers[type->GetRegType()].Get(type->GetRegCount());
+			else local->RegNum = buildit->Registers[REGT_POINTER].Get(1);
 			ctx.FunctionArgs.Push(local);
 		}
 
@@ -837,9 +879,9 @@ void FFunctionBuildList::Build()
 		// If we need extra space, load the frame pointer into a register so that we do not have to call the wasteful LFP instruction more than once.
 		if (item.Function->ExtraSpace > 0)
 		{
-			buildit.FramePointer = ExpEmit(&buildit, REGT_POINTER);
-			buildit.FramePointer.Fixed = true;
-			buildit.Emit(OP_LFP, buildit.FramePointer.RegNum);
+			buildit->FramePointer = ExpEmit(buildit, REGT_POINTER);
+			buildit->FramePointer.Fixed = true;
+			buildit->Emit(OP_LFP, buildit->FramePointer.RegNum);
 		}
 
 		// Make sure resolving it didn't obliterate it.
@@ -857,6 +899,8 @@ void FFunctionBuildList::Build()
 			if (item.Proto == nullptr)
 			{
 				item.Code->ScriptPosition.Message(MSG_ERROR, "Function %s without prototype", item.PrintableName.GetChars());
+				delete buildit;
+				job.Skipped = true;
 				continue;
 			}
 
@@ -868,8 +912,28 @@ void FFunctionBuildList::Build()
 				sfunc->Proto = NewPrototype(item.Proto->ReturnTypes, item.Func->Variants[0].Proto->ArgumentTypes);
 				sfunc->ArgFlags = item.Func->Variants[0].ArgFlags;
 			}
+			job.Builder = buildit;
+			job.Unsafe = ctx.Unsafe;
+			job.Messages.StrictErrors = !item.FromDecorate;
+		}
+		else
+		{
+			delete buildit;
+		}
+	}
 
+	auto emit = [&](unsigned index)
+	{
+		auto &item = mItems[index];
+		auto &job = jobs[index];
+		if (job.Builder == nullptr) return;
+
+		FScriptPosition::Capture = &job.Messages;
+		try
+		{
 			// Emit code
+			VMScriptFunction *sfunc = item.Function;
+			auto &buildit = *job.Builder;
 			try
 			{
 				sfunc->SourceFileName = item.Code->ScriptPosition.FileName;	// remember the file name for printing error messages if something goes wrong in the VM.
@@ -884,15 +948,8 @@ void FFunctionBuildList::Build()
 				{
 					sfunc->NumArgs += s->GetRegCount();
 				}
-
-				if (dump != nullptr)
-				{
-					DumpFunction(dump, sfunc, item.PrintableName.GetChars(), (int)item.PrintableName.Len());
-					codesize += sfunc->CodeSize;
-					datasize += sfunc->LineInfoCount * sizeof(FStatementInfo) + sfunc->ExtraSpace + sfunc->NumKonstD * sizeof(int) +
-						sfunc->NumKonstA * sizeof(void*) + sfunc->NumKonstF * sizeof(double) + sfunc->NumKonstS * sizeof(FString);
-				}
-				sfunc->Unsafe = ctx.Unsafe;
+				sfunc->Unsafe = job.Unsafe;
+				job.Emitted = true;
 			}
 			catch (CRecoverableError &err)
 			{
@@ -900,6 +957,70 @@ void FFunctionBuildList::Build()
 				item.Code->ScriptPosition.Message(MSG_ERROR, "%s in %s", err.GetMessage(), item.PrintableName.GetChars());
 			}
 		}
+		catch (...)
+		{
+			// Gets rethrown on the main thread.
+			job.Error = std::current_exception();
+		}
+		FScriptPosition::Capture = nullptr;
+		delete job.Builder;
+		job.Builder = nullptr;
+	};
+
+	int threads = vm_codegen_threads > 0 ? vm_codegen_threads : (int)std::thread::hardware_concurrency();
+	if (threads <= 1 || mItems.Size() < MIN_CODEGEN_BATCH)
+	{
+		for (unsigned i = 0; i < mItems.Size(); i++)
+		{
+			emit(i);
+		}
+	}
+	else
+	{
+		// The functions vary a lot in size so they are handed out one by one.
+		std::atomic<unsigned> next(0);
+		auto work = [&](int)
+		{
+			unsigned i;
+			while ((i = next++) < mItems.Size())
+			{
+				emit(i);
+			}
+		};
+
+		ctpl::thread_pool pool(threads - 1);
+		std::vector<std::future<void>> futures;
+		for (int i = 0; i < threads - 1; i++)
+		{
+			futures.push_back(pool.push(work));
+		}
+		work(0);
+		for (auto &f : futures)
+		{
+			f.wait();
+		}
+	}
+
+	for (unsigned i = 0; i < mItems.Size(); i++)
+	{
+		auto &item = mItems[i];
+		auto &job = jobs[i];
+		if (job.Skipped) continue;
+
+		job.Messages.Flush();
+		if (job.Error)
+		{
+			if (dump != nullptr) fclose(dump);
+			std::rethrow_exception(job.Error);
+		}
+		if (dump != nullptr && job.Emitted)
+		{
+			auto sfunc = item.Function;
+			DumpFunction(dump, sfunc, item.PrintableName.GetChars(), (int)item.PrintableName.Len());
+			codesize += sfunc->CodeSize;
+			datasize += sfunc->LineInfoCount * sizeof(FStatementInfo) + sfunc->ExtraSpace + sfunc->NumKonstD * sizeof(int) +
+				sfunc->NumKonstA * sizeof(void*) + sfunc->NumKonstF * sizeof(double) + sfunc->NumKonstS * sizeof(FString);
+		}
 		delete item.Code;
 		if (dump != nullptr)
 		{
@@ -915,6 +1036,13 @@ void FFunctionBuildList::Build()
 	FScriptPosition::StrictErrors = false;
 
 	if (FScriptPosition::ErrorCounter == 0 && Args->CheckParm("-dumpjit")) DumpJit();
+	if (FScriptPosition::ErrorCounter == 0)
+	{
+		for (auto &item : mItems)
+		{
+			JitWarmup(item.Function);
+		}
+	}
 	mItems.Clear();
 	mItems.ShrinkToFit();
 	FxAlloc.FreeAllBlocks();
@@ -1037,8 +1165,10 @@ void FunctionCallEmitter::AddParameterIntConst(int konst)
 	});
 }
 
-void FunctionCallEmitter::AddParameterStringConst(const FString &konst)
+void FunctionCallEmitter::AddParameterStringConst(const FString &str)
 {
+	// Default arguments are shared by all callers, so their buffer must not be shared with the copy.
+	FString konst(str.GetChars(), str.Len());
 	numparams++;
 	if (target->VarFlags & VARF_VarArg)
 		reginfo.Push(REGT_STRING);
@@ -1063,7 +1193,11 @@ ExpEmit FunctionCallEmitter::EmitCall(VMFunctionBuilder *build, TArray<ExpEmit>
 	{
 		// Pass a hidden type information parameter to vararg functions.
 		// It would really be nicer to actually pass real types but that'd require a far more complex interface on the compiler side than what we have.
-		uint8_t *regbuffer = (uint8_t*)ClassDataAllocator.Alloc(reginfo.Size());	// Allocate in the arena so that the pointer does not need to be maintained.
+		uint8_t *regbuffer;
+		{
+			std::lock_guard<std::mutex> lock(ArenaMutex);
+			regbuffer = (uint8_t*)ClassDataAllocator.Alloc(reginfo.Size());	// Allocate in the arena so that the pointer does not need to be maintained.
+		}
 		memcpy(regbuffer, reginfo.Data(), reginfo.Size());
 		build->Emit(OP_PARAM, REGT_POINTER | REGT_KONST, build->GetConstantAddress(regbuffer));
 		paramcount++;
@@ -53,6 +53,7 @@
 #include "stats.h"
 #include "info.h"
 #include "thingdef.h"
+#include "d_startuptimer.h"
 
 // EXTERNAL FUNCTION PROTOTYPES --------------------------------------------
 void InitThingdef();
@@ -432,6 +433,7 @@ void SynthesizeFlagFields();
 
 void LoadActors()
 {
+	FStartupPhase phase("LoadActors");
 	cycle_t timer;
 
 	timer.Reset(); timer.Clock();
@@ -439,13 +441,22 @@ void LoadActors()
 
 	InitThingdef();
 	FScriptPosition::StrictErrors = true;
-	ParseScripts();
+	{
+		FStartupPhase phase("ZScript");
+		ParseScripts();
+	}
 
 	FScriptPosition::StrictErrors = false;
-	ParseAllDecorate();
+	{
+		FStartupPhase phase("DECORATE");
+		ParseAllDecorate();
+	}
 	SynthesizeFlagFields();
 
-	FunctionBuildList.Build();
+	{
+		FStartupPhase phase("Code generation");
+		FunctionBuildList.Build();
+	}
 
 	if (FScriptPosition::ErrorCounter > 0)
 	{
@@ -1,14 +1,16 @@
 
 #include "jit.h"
 #include "jitintern.h"
+#include "ctpl.h"
+#include <condition_variable>
 
 extern PString *TypeString;
 extern PStruct *TypeVector2;
 extern PStruct *TypeVector3;
 
-static void OutputJitLog(const asmjit::StringLogger &logger);
+static void OutputJitLog(const char *log);
 
-JitFuncPtr JitCompile(VMScriptFunction *sfunc)
+static JitFuncPtr JitCompile(VMScriptFunction *sfunc, FString &log)
 {
 #if 0
 	if (strcmp(sfunc->PrintableName.GetChars(), "StatusScreen.drawNum") != 0)
@@ -30,12 +32,102 @@ JitFuncPtr JitCompile(VMScriptFunction *sfunc)
 	}
 	catch (const CRecoverableError &e)
 	{
-		OutputJitLog(logger);
-		Printf("%s: Unexpected JIT error: %s\n",sfunc->PrintableName.GetChars(), e.what());
+		log = logger.getString();
+		log.AppendFormat("%s: Unexpected JIT error: %s\n", sfunc->PrintableName.GetChars(), e.what());
 		return nullptr;
 	}
 }
 
+JitFuncPtr JitCompile(VMScriptFunction *sfunc)
+{
+	FString log;
+	JitFuncPtr entry = JitCompile(sfunc, log);
+	if (log.IsNotEmpty()) OutputJitLog(log);
+	return entry;
+}
+
+//==========================================================================
+//
+// Background compilation
+//
+// The first calls of a queued function run in the VM while one of the
+// worker threads compiles it. Only the main thread ever changes the
+// function's ScriptCall, the worker just publishes the new entry point.
+//
+//==========================================================================
+
+static ctpl::thread_pool JitPool;
+static std::mutex JitQueueMutex;
+static std::condition_variable JitQueueDone;
+static int JitPendingJobs = 0;
+static std::mutex JitLogMutex;
+static FString JitPendingLog;
+
+void JitQueueCompile(VMScriptFunction *sfunc)
+{
+	if (JitPool.size() == 0)
+	{
+		JitPool.resize(MAX<int>(std::thread::hardware_concurrency() - 1, 1));
+	}
+
+	sfunc->JitQueued = true;
+	{
+		std::lock_guard<std::mutex> lock(JitQueueMutex);
+		JitPendingJobs++;
+	}
+	JitPool.push([=](int)
+	{
+		FString log;
+		JitFuncPtr entry;
+		try
+		{
+			entry = JitCompile(sfunc, log);
+		}
+		catch (const std::exception &e)
+		{
+			log.Format("%s: Unexpected JIT error: %s\n", sfunc->PrintableName.GetChars(), e.what());
+			entry = nullptr;
+		}
+		catch (...)
+		{
+			log.Format("%s: Unexpected JIT error\n", sfunc->PrintableName.GetChars());
+			entry = nullptr;
+		}
+		if (log.IsNotEmpty())
+		{
+			std::lock_guard<std::mutex> lock(JitLogMutex);
+			JitPendingLog += log.GetChars();
+		}
+		sfunc->JitEntry.store(entry != nullptr ? entry : VMExec, std::memory_order_release);
+
+		std::lock_guard<std::mutex> lock(JitQueueMutex);
+		if (--JitPendingJobs == 0) JitQueueDone.notify_all();
+	});
+}
+
+JitFuncPtr JitGetCompiled(VMScriptFunction *sfunc)
+{
+	JitFuncPtr entry = sfunc->JitEntry.load(std::memory_order_acquire);
+	if (entry != nullptr)
+	{
+		// Copy the characters so that no string data is shared with the workers.
+		FString log;
+		{
+			std::lock_guard<std::mutex> lock(JitLogMutex);
+			log = JitPendingLog.GetChars();
+			JitPendingLog = "";
+		}
+		if (log.IsNotEmpty()) OutputJitLog(log);
+	}
+	return entry;
+}
+
+void JitWaitQueue()
+{
+	std::unique_lock<std::mutex> lock(JitQueueMutex);
+	JitQueueDone.wait(lock, [] { return JitPendingJobs == 0; });
+}
+
 void JitDumpLog(FILE *file, VMScriptFunction *sfunc)
 {
 	using namespace asmjit;
@@ -66,10 +158,10 @@ void JitDumpLog(FILE *file, VMScriptFunction *sfunc)
 	}
 }
 
-static void OutputJitLog(const asmjit::StringLogger &logger)
+static void OutputJitLog(const char *log)
 {
 	// Write line by line since I_FatalError seems to cut off long strings
-	const char *pos = logger.getString();
+	const char *pos = log;
 	const char *end = pos;
 	while (*end)
 	{
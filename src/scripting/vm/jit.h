@@ -4,5 +4,9 @@
 #include "vmintern.h"
 
 JitFuncPtr JitCompile(VMScriptFunction *func);
+void JitQueueCompile(VMScriptFunction *func);
+JitFuncPtr JitGetCompiled(VMScriptFunction *func);
+void JitWarmup(VMScriptFunction *func);
+void JitResetCallCaches();
 void JitDumpLog(FILE *file, VMScriptFunction *func);
 FString JitCaptureStackTrace(int framesToSkip, bool includeNativeFrames);
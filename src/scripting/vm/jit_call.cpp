@@ -2,6 +2,10 @@
 #include "jitintern.h"
 #include <map>
 #include <memory>
+#include <mutex>
+#include "c_cvars.h"
+
+EXTERN_CVAR(Bool, vm_jit_callstats)
 
 void JitCompiler::EmitPARAM()
 {
@@ -25,7 +29,7 @@ void JitCompiler::EmitVTBL()
 	// This instruction is handled in the CALL/CALL_K instruction following it
 }
 
-void JitCompiler::EmitVtbl(const VMOP *op)
+void JitCompiler::EmitVtbl(const VMOP *op, asmjit::X86Gp scriptcall)
 {
 	int a = op->a;
 	int b = op->b;
@@ -35,9 +39,38 @@ void JitCompiler::EmitVtbl(const VMOP *op)
 	cc.test(regA[b], regA[b]);
 	cc.jz(label);
 
-	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[b], myoffsetof(DObject, Class)));
-	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[a], myoffsetof(PClass, Virtuals) + myoffsetof(FArray, Array)));
-	cc.mov(regA[a], asmjit::x86::qword_ptr(regA[a], c * (int)sizeof(void*)));
+	// Most call sites only ever see one class. If the receiver has the same
+	// class as last time, the cached target and its entry point are used
+	// without going through the vtable and the target's ScriptCall. Neither
+	// load depends on the class load.
+	JitCallCache *cache = AddJitCallCache(sfunc, sfunc->PCToLine(op), c);
+	auto cacheptr = newTempIntPtr();
+	auto cls = newTempIntPtr();
+	auto miss = cc.newLabel();
+	auto done = cc.newLabel();
+
+	cc.mov(cacheptr, asmjit::imm_ptr(cache));
+	cc.mov(cls, asmjit::x86::qword_ptr(regA[b], myoffsetof(DObject, Class)));
+	cc.cmp(cls, asmjit::x86::qword_ptr(cacheptr, myoffsetof(JitCallCache, Class)));
+	cc.jne(miss);
+	cc.mov(regA[a], asmjit::x86::qword_ptr(cacheptr, myoffsetof(JitCallCache, Target)));
+	cc.mov(scriptcall, asmjit::x86::qword_ptr(cacheptr, myoffsetof(JitCallCache, Entry)));
+	if (vm_jit_callstats)
+	{
+		cc.add(asmjit::x86::qword_ptr(cacheptr, myoffsetof(JitCallCache, Hits)), 1);
+	}
+	cc.jmp(done);
+
+	cc.bind(miss);
+	auto result = newResultIntPtr();
+	auto call = CreateCall<VMFunction *, JitCallCache *, PClass *>(JitCallCacheMiss);
+	call->setRet(0, result);
+	call->setArg(0, cacheptr);
+	call->setArg(1, cls);
+	cc.mov(regA[a], result);
+	cc.mov(scriptcall, asmjit::x86::qword_ptr(regA[a], myoffsetof(VMScriptFunction, ScriptCall)));
+
+	cc.bind(done);
 }
 
 void JitCompiler::EmitCALL()
@@ -78,17 +111,17 @@ void JitCompiler::EmitVMCall(asmjit::X86Gp vmfunc, VMFunction *target)
 	if (numparams != B)
 		I_Error("OP_CALL parameter count does not match the number of preceding OP_PARAM instructions");
 
+	auto scriptcall = newTempIntPtr();
 	if ((pc - 1)->op == OP_VTBL)
-		EmitVtbl(pc - 1);
+		EmitVtbl(pc - 1, scriptcall);
+	else
+		cc.mov(scriptcall, x86::ptr(vmfunc, myoffsetof(VMScriptFunction, ScriptCall)));
 
 	FillReturns(pc + 1, C);
 
 	X86Gp paramsptr = newTempIntPtr();
 	cc.lea(paramsptr, x86::ptr(vmframe, offsetParams));
 
-	auto scriptcall = newTempIntPtr();
-	cc.mov(scriptcall, x86::ptr(vmfunc, myoffsetof(VMScriptFunction, ScriptCall)));
-
 	auto result = newResultInt32();
 	auto call = cc.call(scriptcall, FuncSignature5<int, VMFunction *, VMValue*, int, VMReturn*, int>());
 	call->setRet(0, result);
@@ -394,10 +427,33 @@ void JitCompiler::EmitNativeCall(VMNativeFunction *target)
 				call->setArg(slot, tmp2);
 				break;
 
+			// References to registers are passed as a pointer into the frame, same as for script calls.
+			// LoadInOuts moves the values back into the virtual registers after the call.
 			case REGT_INT | REGT_ADDROF:
+				CheckVMFrame();
+				tmp = newTempIntPtr();
+				cc.lea(tmp, x86::ptr(vmframe, offsetD + (int)(bc * sizeof(int32_t))));
+				cc.mov(x86::dword_ptr(tmp), regD[bc]);
+				call->setArg(slot, tmp);
+				break;
 			case REGT_POINTER | REGT_ADDROF:
+				CheckVMFrame();
+				tmp = newTempIntPtr();
+				cc.lea(tmp, x86::ptr(vmframe, offsetA + (int)(bc * sizeof(void*))));
+				cc.mov(x86::ptr(tmp), regA[bc]);
+				call->setArg(slot, tmp);
+				break;
 			case REGT_FLOAT | REGT_ADDROF:
-				I_Error("REGT_ADDROF not implemented for native direct calls\n");
+				CheckVMFrame();
+				tmp = newTempIntPtr();
+				cc.lea(tmp, x86::ptr(vmframe, offsetF + (int)(bc * sizeof(double))));
+				// We don't know if the receiving function will treat it as float, vec2 or vec3.
+				for (int j = 0; j < 3; j++)
+				{
+					if ((unsigned int)(bc + j) < regF.Size())
+						cc.movsd(x86::qword_ptr(tmp, j * sizeof(double)), regF[bc + j]);
+				}
+				call->setArg(slot, tmp);
 				break;
 
 			default:
@@ -480,6 +536,8 @@ void JitCompiler::EmitNativeCall(VMNativeFunction *target)
 
 	cc.setCursor(cursorAfter);
 
+	LoadInOuts();
+
 	if (startret == 1 && numret > 0)
 	{
 		int type = retval[0].b;
@@ -544,6 +602,7 @@ void JitCompiler::EmitNativeCall(VMNativeFunction *target)
 }
 
 static std::map<FString, std::unique_ptr<TArray<uint8_t>>> argsCache;
+static std::mutex argsCacheMutex;	// Functions may be compiled on several threads at once
 
 asmjit::FuncSignature JitCompiler::CreateFuncSignature()
 {
@@ -659,6 +718,7 @@ asmjit::FuncSignature JitCompiler::CreateFuncSignature()
 	}
 
 	// FuncSignature only keeps a pointer to its args array. Store a copy of each args array variant.
+	std::lock_guard<std::mutex> lock(argsCacheMutex);
 	std::unique_ptr<TArray<uint8_t>> &cachedArgs = argsCache[key];
 	if (!cachedArgs) cachedArgs.reset(new TArray<uint8_t>(args));
 
@@ -1,6 +1,10 @@
 
 #include "jit.h"
+#include <mutex>
+#include <algorithm>
 #include "jitintern.h"
+#include "c_dispatch.h"
+#include "c_cvars.h"
 
 #ifdef WIN32
 #include <DbgHelp.h>
@@ -25,18 +29,19 @@ static TArray<uint8_t*> JitBlocks;
 static TArray<uint8_t*> JitFrames;
 static size_t JitBlockPos = 0;
 static size_t JitBlockSize = 0;
+static TDeletingArray<JitCallCache*> JitCallCaches;
+
+// Functions can be compiled by the background threads. Code generation runs
+// in parallel, this protects the shared memory blocks and debug info.
+static std::mutex JitMutex;
 
 asmjit::CodeInfo GetHostCodeInfo()
 {
-	static bool firstCall = true;
-	static asmjit::CodeInfo codeInfo;
-
-	if (firstCall)
+	static const asmjit::CodeInfo codeInfo = []
 	{
 		asmjit::JitRuntime rt;
-		codeInfo = rt.getCodeInfo();
-		firstCall = false;
-	}
+		return rt.getCodeInfo();
+	}();
 
 	return codeInfo;
 }
@@ -259,6 +264,8 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 	if (codeSize == 0)
 		return nullptr;
 
+	std::lock_guard<std::mutex> lock(JitMutex);
+
 #ifdef _WIN64
 	TArray<uint16_t> unwindInfo = CreateUnwindInfoWindows(func);
 	size_t unwindInfoSize = unwindInfo.Size() * sizeof(uint16_t);
@@ -302,7 +309,9 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 	if (result == 0)
 		I_Error("RtlAddFunctionTable failed");
 
-	JitDebugInfo.Push({ compiler->GetScriptFunction()->PrintableName, compiler->GetScriptFunction()->SourceFileName, compiler->LineInfo, startaddr, endaddr });
+	// The names get copied because this can run on a worker thread and FString's reference counting is not atomic.
+	auto sfunc = compiler->GetScriptFunction();
+	JitDebugInfo.Push({ FString(sfunc->PrintableName.GetChars()), FString(sfunc->SourceFileName.GetChars()), compiler->LineInfo, startaddr, endaddr });
 #endif
 
 	return p;
@@ -655,6 +664,8 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 	if (codeSize == 0)
 		return nullptr;
 
+	std::lock_guard<std::mutex> lock(JitMutex);
+
 	unsigned int fdeFunctionStart = 0;
 	TArray<uint8_t> unwindInfo = CreateUnwindInfoUnix(func, fdeFunctionStart);
 	size_t unwindInfoSize = unwindInfo.Size();
@@ -726,7 +737,9 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 #endif
 	}
 
-	JitDebugInfo.Push({ compiler->GetScriptFunction()->PrintableName, compiler->GetScriptFunction()->SourceFileName, compiler->LineInfo, startaddr, endaddr });
+	// The names get copied because this can run on a worker thread and FString's reference counting is not atomic.
+	auto sfunc = compiler->GetScriptFunction();
+	JitDebugInfo.Push({ FString(sfunc->PrintableName.GetChars()), FString(sfunc->SourceFileName.GetChars()), compiler->LineInfo, startaddr, endaddr });
 
 	return p;
 }
@@ -734,6 +747,7 @@ void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler)
 
 void JitRelease()
 {
+	std::lock_guard<std::mutex> lock(JitMutex);
 #ifdef _WIN64
 	for (auto p : JitFrames)
 	{
@@ -750,12 +764,111 @@ void JitRelease()
 		asmjit::OSUtils::releaseVirtualMemory(p, 1024 * 1024);
 	}
 	JitDebugInfo.Clear();
+	JitCallCaches.DeleteAndClear();
 	JitFrames.Clear();
 	JitBlocks.Clear();
 	JitBlockPos = 0;
 	JitBlockSize = 0;
 }
 
+JitCallCache *AddJitCallCache(VMScriptFunction *caller, int line, int vindex)
+{
+	std::lock_guard<std::mutex> lock(JitMutex);
+	auto cache = new JitCallCache;
+	cache->Caller = caller;
+	cache->Line = line;
+	cache->VIndex = vindex;
+	JitCallCaches.Push(cache);
+	return cache;
+}
+
+//==========================================================================
+//
+// JitCallCacheMiss
+//
+// Called by the generated code when the receiver's class is not the cached
+// one. Functions that have not been called yet still point to the code that
+// picks their entry point, so they are not cached until that is done.
+//
+//==========================================================================
+
+VMFunction *JitCallCacheMiss(JitCallCache *cache, PClass *cls)
+{
+	VMFunction *target = cls->Virtuals[cache->VIndex];
+	cache->Misses++;
+	if ((target->VarFlags & VARF_Native) || static_cast<VMScriptFunction *>(target)->HasEntryPoint())
+	{
+		cache->Class = cls;
+		cache->Target = target;
+		cache->Entry = target->ScriptCall;
+	}
+	return target;
+}
+
+//==========================================================================
+//
+// JitResetCallCaches
+//
+// Must be called whenever script functions get a different ScriptCall.
+//
+//==========================================================================
+
+void JitResetCallCaches()
+{
+	std::lock_guard<std::mutex> lock(JitMutex);
+	for (auto cache : JitCallCaches)
+	{
+		cache->Class = nullptr;
+	}
+}
+
+//==========================================================================
+//
+// CCMD vmcallcaches
+//
+// Lists the virtual call sites that miss their inline cache most often.
+// Hits are only counted in functions compiled while vm_jit_callstats is on
+// so that the call sites don't pay for it otherwise.
+//
+//==========================================================================
+
+CVAR(Bool, vm_jit_callstats, false, 0)
+
+CCMD(vmcallcaches)
+{
+	std::lock_guard<std::mutex> lock(JitMutex);
+
+	if (argv.argc() >= 2 && stricmp(argv[1], "reset") == 0)
+	{
+		for (auto cache : JitCallCaches)
+		{
+			cache->Hits = cache->Misses = 0;
+		}
+		return;
+	}
+
+	unsigned limit = argv.argc() >= 2 ? (unsigned)atoi(argv[1]) : 20;
+	uint64_t hits = 0, misses = 0;
+	TArray<JitCallCache*> sites;
+	for (auto cache : JitCallCaches)
+	{
+		hits += cache->Hits;
+		misses += cache->Misses;
+		if (cache->Misses > 0) sites.Push(cache);
+	}
+	std::sort(sites.begin(), sites.end(), [](JitCallCache *a, JitCallCache *b) { return a->Misses > b->Misses; });
+
+	Printf("%u call sites, %llu hits, %llu misses\n", JitCallCaches.Size(), (unsigned long long)hits, (unsigned long long)misses);
+	if (!vm_jit_callstats) Printf("Hits are only counted in functions compiled with vm_jit_callstats enabled\n");
+	for (unsigned i = 0; i < sites.Size() && i < limit; i++)
+	{
+		auto cache = sites[i];
+		Printf("%10llu %10llu  %s (%s:%d) -> %s\n", (unsigned long long)cache->Misses, (unsigned long long)cache->Hits,
+			cache->Caller->PrintableName.GetChars(), cache->Caller->SourceFileName.GetChars(), cache->Line,
+			cache->Target ? cache->Target->PrintableName.GetChars() : "(not called yet)");
+	}
+}
+
 static int CaptureStackTrace(int max_frames, void **out_frames)
 {
 	memset(out_frames, 0, sizeof(void *) * max_frames);
@@ -928,6 +1041,7 @@ int JITPCToLine(uint8_t *pc, const JitFuncInfo *info)
 
 FString JitGetStackFrameName(NativeSymbolResolver *nativeSymbols, void *pc)
 {
+	std::lock_guard<std::mutex> lock(JitMutex);
 	for (unsigned int i = 0; i < JitDebugInfo.Size(); i++)
 	{
 		const auto &info = JitDebugInfo[i];
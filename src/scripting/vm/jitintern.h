@@ -25,6 +25,22 @@ extern int VMCalls[10];
 #define ABCs			(pc[0].i24)
 #define JMPOFS(x)		((x)->i24)
 
+// Inline cache for a virtual call site. The generated code compares the
+// receiver's class against the one seen last and calls the cached entry
+// point directly if it matches. Otherwise JitCallCacheMiss does the vtable
+// lookup and replaces the cached target.
+struct JitCallCache
+{
+	PClass *Class = nullptr;
+	VMFunction *Target = nullptr;
+	JitFuncPtr Entry = nullptr;		// Target's ScriptCall when it was cached
+	uint64_t Hits = 0;				// only counted with vm_jit_callstats
+	uint64_t Misses = 0;
+	VMScriptFunction *Caller = nullptr;
+	int Line = 0;
+	int VIndex = 0;
+};
+
 struct JitLineInfo
 {
 	ptrdiff_t InstructionIndex = 0;
@@ -62,7 +78,7 @@ private:
 
 	void EmitNativeCall(VMNativeFunction *target);
 	void EmitVMCall(asmjit::X86Gp ptr, VMFunction *target);
-	void EmitVtbl(const VMOP *op);
+	void EmitVtbl(const VMOP *op, asmjit::X86Gp scriptcall);
 
 	int StoreCallParams();
 	void LoadInOuts();
@@ -319,4 +335,6 @@ public:
 };
 
 void *AddJitFunction(asmjit::CodeHolder* code, JitCompiler *compiler);
+JitCallCache *AddJitCallCache(VMScriptFunction *caller, int line, int vindex);
+VMFunction *JitCallCacheMiss(JitCallCache *cache, PClass *cls);
 asmjit::CodeInfo GetHostCodeInfo();
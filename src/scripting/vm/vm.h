@@ -54,6 +54,8 @@ extern FMemArena ClassDataAllocator;
 #define MAX_TRY_DEPTH	8	// Maximum number of nested TRYs in a single function
 
 void JitRelease();
+void JitWaitQueue();
+void VMProfileRelease();
 
 
 typedef unsigned char		VM_UBYTE;
@@ -425,13 +427,16 @@ public:
 	void operator delete[](void *block) {}
 	static void DeleteAll()
 	{
+		// the background compiler may still be looking at some functions.
+		JitWaitQueue();
 		for (auto f : AllFunctions)
 		{
 			f->~VMFunction();
 		}
 		AllFunctions.Clear();
-		// also release any JIT data
+		// also release any JIT and profiling data
 		JitRelease();
+		VMProfileRelease();
 	}
 	static void CreateRegUseInfo()
 	{
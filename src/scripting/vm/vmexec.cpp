@@ -128,6 +128,26 @@ struct VMExec_Unchecked
 {
 #include "vmexec.h"
 };
+
+// Counts every executed instruction for the profiler's per-line mode.
+#define VM_PROFILE_LINES
+#undef NEXTOP
+#if COMPGOTO
+#define NEXTOP	do { pc++; opcounts[pc - sfunc->Code]++; unsigned op = pc->op; a = pc->a; goto *ops[op]; } while(0)
+#else
+#define NEXTOP	pc++; opcounts[pc - sfunc->Code]++; break
+#endif
+struct VMExec_LineProfile
+{
+#include "vmexec.h"
+};
+#undef VM_PROFILE_LINES
+#undef NEXTOP
+#if COMPGOTO
+#define NEXTOP	do { pc++; unsigned op = pc->op; a = pc->a; goto *ops[op]; } while(0)
+#else
+#define NEXTOP	pc++; break
+#endif
 #if !WAS_NDEBUG
 #undef NDEBUG
 #endif
@@ -142,6 +162,8 @@ VMExec_Checked::Exec
 #endif
 ;
 
+int (*VMExecLineProfile)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret) = VMExec_LineProfile::Exec;
+
 // Note: If the VM is being used in multiple threads, this should be declared as thread_local.
 // ZDoom doesn't need this at the moment so this is disabled.
 
@@ -55,6 +55,9 @@ static int ExecScriptFunc(VMFrameStack *stack, VMReturn *ret, int numret)
 	const FString *konsts = sfunc->KonstS;
 	const FVoidObj *konsta = sfunc->KonstA;
 	const VMOP *pc = sfunc->Code;
+#ifdef VM_PROFILE_LINES
+	unsigned *opcounts = VMProfileOpCounts(sfunc);
+#endif
 
 	assert(!(f->Func->VarFlags & VARF_Native) && "Only script functions should ever reach VMExec");
 
@@ -54,6 +54,8 @@ CUSTOM_CVAR(Bool, vm_jit, true, CVAR_NOINITCALL)
 	Printf("You must restart " GAMENAME " for this change to take effect.\n");
 	Printf("This cvar is currently not saved. You must specify it on the command line.");
 }
+CVAR(Bool, vm_jit_background, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// compile on worker threads and run the VM until it is done
+CVAR(Bool, vm_jit_warmup, false, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)		// compile everything in the background right after the scripts were loaded
 #else
 CVAR(Bool, vm_jit, false, CVAR_NOINITCALL|CVAR_NOSET)
 #endif
@@ -282,22 +284,60 @@ static bool CanJit(VMScriptFunction *func)
 
 int VMScriptFunction::FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
 {
+	auto sfunc = static_cast<VMScriptFunction*>(func);
+	JitFuncPtr entry;
 #ifdef ARCH_X64
-	if (vm_jit && CanJit(static_cast<VMScriptFunction*>(func)))
+	if (sfunc->JitQueued)
 	{
-		func->ScriptCall = JitCompile(static_cast<VMScriptFunction*>(func));
-		if (!func->ScriptCall)
-			func->ScriptCall = VMExec;
+		// Keep using the VM until the background compiler is done with it.
+		entry = JitGetCompiled(sfunc);
+		if (entry == nullptr)
+			return VMExec(func, params, numparams, ret, numret);
+	}
+	else if (vm_jit && CanJit(sfunc))
+	{
+		if (vm_jit_background)
+		{
+			JitQueueCompile(sfunc);
+			return VMExec(func, params, numparams, ret, numret);
+		}
+		entry = JitCompile(sfunc);
+		if (!entry)
+			entry = VMExec;
 	}
 	else
 	{
-		func->ScriptCall = VMExec;
+		entry = VMExec;
 	}
 #else
-	func->ScriptCall = VMExec;
+	entry = VMExec;
 #endif
 
-	return func->ScriptCall(func, params, numparams, ret, numret);
+	// If the profiler is running, it must stay in front of the real entry point.
+	if (sfunc->ScriptCall == &VMScriptFunction::FirstScriptCall)
+		sfunc->ScriptCall = entry;
+	else
+		sfunc->UnprofiledScriptCall = entry;
+
+	return entry(func, params, numparams, ret, numret);
+}
+
+//==========================================================================
+//
+// JitWarmup
+//
+// Starts compiling a function in the background before it gets called.
+//
+//==========================================================================
+
+void JitWarmup(VMScriptFunction *sfunc)
+{
+#ifdef ARCH_X64
+	if (vm_jit && vm_jit_background && vm_jit_warmup && !sfunc->JitQueued && CanJit(sfunc))
+	{
+		JitQueueCompile(sfunc);
+	}
+#endif
 }
 
 int VMNativeFunction::NativeScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *returns, int numret)
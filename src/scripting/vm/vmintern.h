@@ -2,6 +2,7 @@
 
 #include "vm.h"
 #include <csetjmp>
+#include <atomic>
 
 class VMScriptFunction;
 
@@ -430,6 +431,8 @@ enum EVMEngine
 
 void VMSelectEngine(EVMEngine engine);
 extern int (*VMExec)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+extern int (*VMExecLineProfile)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
+unsigned *VMProfileOpCounts(VMScriptFunction *func);
 void VMFillParams(VMValue *params, VMFrame *callee, int numparam);
 
 void VMDumpConstants(FILE *out, const VMScriptFunction *func);
@@ -471,11 +474,21 @@ public:
 	VM_UBYTE NumArgs;		// Number of arguments this function takes
 	TArray<FTypeAndOffset> SpecialInits;	// list of all contents on the extra stack which require construction and destruction
 
+	// While the profiler is running ScriptCall points to the profiler and this holds the real entry point.
+	int(*UnprofiledScriptCall)(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret) = nullptr;
+
+	// Set by the background JIT compiler once the native code is ready to be used.
+	std::atomic<JitFuncPtr> JitEntry { nullptr };
+	bool JitQueued = false;
+
 	void InitExtra(void *addr);
 	void DestroyExtra(void *addr);
 	int AllocExtraStack(PType *type);
 	int PCToLine(const VMOP *pc);
 
+	// False until the first call has decided between the JIT and the VM.
+	bool HasEntryPoint() const { return ScriptCall != &FirstScriptCall; }
+
 private:
 	static int FirstScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret);
 };
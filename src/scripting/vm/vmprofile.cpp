@@ -0,0 +1,440 @@
+/*
+** vmprofile.cpp
+** Instrumenting profiler for script functions
+**
+**---------------------------------------------------------------------------
+** Copyright 2018 GZDoom Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** While the profiler is running every script function's ScriptCall is
+** redirected to ProfiledScriptCall which records the time spent in it
+** before passing the call on to the JIT or the interpreter. This way
+** nothing needs to be checked while the profiler is off.
+**
+** Native functions are not tracked separately. The time spent in them
+** is part of the calling script function's exclusive time.
+**
+** In per-line mode all script code runs through an interpreter that
+** counts every executed instruction. These counts are mapped to source
+** lines with the function's line number table when writing the report.
+*/
+
+#include <algorithm>
+#include "dobject.h"
+#include "v_text.h"
+#include "stats.h"
+#include "c_dispatch.h"
+#include "templates.h"
+#include "files.h"
+#include "vmintern.h"
+#include "types.h"
+#include "jit.h"
+
+struct FVMFunctionProfile
+{
+	VMScriptFunction *Func;
+	int Calls = 0;
+	int Depth = 0;			// for recursive functions only the outermost call counts towards the inclusive time.
+	double Inclusive = 0;
+	double Exclusive = 0;
+	TArray<unsigned> OpCounts;
+};
+
+// Node of the call tree used for writing the collapsed stacks.
+struct FVMProfileNode
+{
+	unsigned Profile;
+	unsigned Parent;
+	unsigned FirstChild;
+	unsigned NextSibling;
+	double Exclusive;
+};
+
+struct FVMProfileFrame
+{
+	unsigned Profile;
+	unsigned Node;
+	double ChildTime;
+	cycle_t Timer;
+};
+
+static bool Profiling;
+static bool ProfileLines;
+static int ProfileGeneration;
+static TArray<FVMFunctionProfile> Profiles;
+static TMap<VMScriptFunction *, unsigned> ProfileIndex;
+static TArray<FVMProfileNode> Nodes;
+static TArray<FVMProfileFrame> ProfileStack;
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
+static unsigned GetProfile(VMScriptFunction *func)
+{
+	unsigned *index = ProfileIndex.CheckKey(func);
+	if (index != nullptr)
+	{
+		return *index;
+	}
+	unsigned i = Profiles.Reserve(1);
+	Profiles[i].Func = func;
+	ProfileIndex[func] = i;
+	return i;
+}
+
+static unsigned GetChildNode(unsigned parent, unsigned profile)
+{
+	for (unsigned child = Nodes[parent].FirstChild; child != 0; child = Nodes[child].NextSibling)
+	{
+		if (Nodes[child].Profile == profile)
+		{
+			return child;
+		}
+	}
+	unsigned node = Nodes.Push({ profile, parent, 0, Nodes[parent].FirstChild, 0 });
+	Nodes[parent].FirstChild = node;
+	return node;
+}
+
+static void ClearProfile()
+{
+	Profiles.Clear();
+	ProfileIndex.Clear();
+	ProfileStack.Clear();
+	Nodes.Clear();
+	Nodes.Push({ ~0u, 0, 0, 0, 0 });	// the root
+	ProfileGeneration++;
+}
+
+//==========================================================================
+//
+// VMProfileOpCounts
+//
+// Used by the line profiling interpreter.
+//
+//==========================================================================
+
+unsigned *VMProfileOpCounts(VMScriptFunction *func)
+{
+	auto &prof = Profiles[GetProfile(func)];
+	if (prof.OpCounts.Size() == 0)
+	{
+		prof.OpCounts.Resize(func->CodeSize);
+		memset(prof.OpCounts.Data(), 0, func->CodeSize * sizeof(unsigned));
+	}
+	return prof.OpCounts.Data();
+}
+
+//==========================================================================
+//
+// FVMProfileScope
+//
+// Makes sure that the profile stack stays intact when a script aborts.
+//
+//==========================================================================
+
+class FVMProfileScope
+{
+	int Generation;
+
+public:
+	FVMProfileScope(VMScriptFunction *func)
+	{
+		Generation = ProfileGeneration;
+
+		unsigned profile = GetProfile(func);
+		Profiles[profile].Calls++;
+		Profiles[profile].Depth++;
+
+		unsigned parent = ProfileStack.Size() > 0 ? ProfileStack.Last().Node : 0;
+		unsigned i = ProfileStack.Reserve(1);
+		auto &frame = ProfileStack[i];
+		frame.Profile = profile;
+		frame.Node = GetChildNode(parent, profile);
+		frame.ChildTime = 0;
+		frame.Timer.Reset();
+		frame.Timer.Clock();
+	}
+
+	~FVMProfileScope()
+	{
+		// The profile may have been cleared while this function was running.
+		if (Generation != ProfileGeneration || ProfileStack.Size() == 0)
+		{
+			return;
+		}
+
+		FVMProfileFrame frame = ProfileStack.Last();
+		frame.Timer.Unclock();
+		ProfileStack.Pop();
+
+		double inclusive = frame.Timer.TimeMS();
+		double exclusive = inclusive - frame.ChildTime;
+		auto &prof = Profiles[frame.Profile];
+		if (--prof.Depth == 0)
+		{
+			prof.Inclusive += inclusive;
+		}
+		prof.Exclusive += exclusive;
+		Nodes[frame.Node].Exclusive += exclusive;
+
+		if (ProfileStack.Size() > 0)
+		{
+			ProfileStack.Last().ChildTime += inclusive;
+		}
+	}
+};
+
+static int ProfiledScriptCall(VMFunction *func, VMValue *params, int numparams, VMReturn *ret, int numret)
+{
+	auto sfunc = static_cast<VMScriptFunction *>(func);
+	FVMProfileScope scope(sfunc);
+	if (ProfileLines)
+	{
+		return VMExecLineProfile(func, params, numparams, ret, numret);
+	}
+	return sfunc->UnprofiledScriptCall(func, params, numparams, ret, numret);
+}
+
+//==========================================================================
+//
+// Start / Stop
+//
+//==========================================================================
+
+static void StartProfiling(bool lines)
+{
+	if (Profiling)
+	{
+		ProfileLines = lines;
+		return;
+	}
+
+	ClearProfile();
+	for (auto func : VMFunction::AllFunctions)
+	{
+		if (!(func->VarFlags & VARF_Native))
+		{
+			auto sfunc = static_cast<VMScriptFunction *>(func);
+			sfunc->UnprofiledScriptCall = sfunc->ScriptCall;
+			sfunc->ScriptCall = ProfiledScriptCall;
+		}
+	}
+	JitResetCallCaches();
+	Profiling = true;
+	ProfileLines = lines;
+}
+
+static void StopProfiling()
+{
+	if (!Profiling)
+	{
+		return;
+	}
+
+	for (auto func : VMFunction::AllFunctions)
+	{
+		if (!(func->VarFlags & VARF_Native))
+		{
+			auto sfunc = static_cast<VMScriptFunction *>(func);
+			sfunc->ScriptCall = sfunc->UnprofiledScriptCall;
+			sfunc->UnprofiledScriptCall = nullptr;
+		}
+	}
+	JitResetCallCaches();
+	Profiling = false;
+	ProfileLines = false;
+}
+
+//==========================================================================
+//
+// VMProfileRelease
+//
+// The functions are about to be deleted so nothing may refer to them
+// anymore.
+//
+//==========================================================================
+
+void VMProfileRelease()
+{
+	StopProfiling();
+	ClearProfile();
+}
+
+//==========================================================================
+//
+// Report writers
+//
+//==========================================================================
+
+static void WriteFlatReport(FileWriter *f, unsigned limit)
+{
+	TArray<unsigned> sorted;
+	for (unsigned i = 0; i < Profiles.Size(); i++)
+	{
+		if (Profiles[i].Calls > 0) sorted.Push(i);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](unsigned a, unsigned b)
+	{
+		return Profiles[b].Exclusive < Profiles[a].Exclusive;
+	});
+
+	const unsigned count = MIN(limit > 0 ? limit : UINT_MAX, sorted.Size());
+	f->Printf("Excl, ms      Incl, ms      Calls       Function\n");
+	for (unsigned i = 0; i < count; i++)
+	{
+		auto &prof = Profiles[sorted[i]];
+		f->Printf("%12.4f  %12.4f  %10d  %s (%s)\n", prof.Exclusive, prof.Inclusive, prof.Calls,
+			prof.Func->PrintableName.GetChars(), prof.Func->SourceFileName.GetChars());
+	}
+}
+
+static void WriteLineReport(FileWriter *f, unsigned limit)
+{
+	struct LineCount
+	{
+		VMScriptFunction *Func;
+		int Line;
+		unsigned Count;
+	};
+	TArray<LineCount> lines;
+
+	for (auto &prof : Profiles)
+	{
+		auto func = prof.Func;
+		if (prof.OpCounts.Size() == 0) continue;
+
+		// Merge consecutive instructions of the same line.
+		unsigned start = lines.Size();
+		for (int pc = 0; pc < func->CodeSize; pc++)
+		{
+			if (prof.OpCounts[pc] == 0) continue;
+			int line = func->PCToLine(func->Code + pc);
+			unsigned j;
+			for (j = start; j < lines.Size() && lines[j].Line != line; j++);
+			if (j == lines.Size()) lines.Push({ func, line, 0 });
+			lines[j].Count += prof.OpCounts[pc];
+		}
+	}
+
+	std::sort(lines.begin(), lines.end(), [](const LineCount &a, const LineCount &b)
+	{
+		return b.Count < a.Count;
+	});
+
+	const unsigned count = MIN(limit > 0 ? limit : UINT_MAX, lines.Size());
+	f->Printf("\nInstructions  Line\n");
+	for (unsigned i = 0; i < count; i++)
+	{
+		f->Printf("%12u  %s:%d (%s)\n", lines[i].Count, lines[i].Func->SourceFileName.GetChars(), lines[i].Line,
+			lines[i].Func->PrintableName.GetChars());
+	}
+}
+
+// Writes the call tree in the format used by flamegraph.pl and compatible tools.
+static void WriteCollapsedStacks(FileWriter *f, unsigned node, const FString &path)
+{
+	for (unsigned child = Nodes[node].FirstChild; child != 0; child = Nodes[child].NextSibling)
+	{
+		FString name = Profiles[Nodes[child].Profile].Func->PrintableName;
+		name.ReplaceChars("; ", '_');
+
+		FString childpath = path.IsEmpty() ? name : path + ";" + name;
+		int64_t us = int64_t(Nodes[child].Exclusive * 1000);
+		if (us > 0)
+		{
+			f->Printf("%s %lld\n", childpath.GetChars(), (long long)us);
+		}
+		WriteCollapsedStacks(f, child, childpath);
+	}
+}
+
+static void WriteProfile(const char *filename, unsigned limit)
+{
+	FileWriter *f = FileWriter::Open(filename);
+	if (f == nullptr)
+	{
+		Printf("Unable to open %s\n", filename);
+		return;
+	}
+	WriteFlatReport(f, limit);
+	WriteLineReport(f, limit);
+	delete f;
+
+	FString stackname = filename;
+	stackname += ".folded";
+	f = FileWriter::Open(stackname);
+	if (f == nullptr)
+	{
+		Printf("Unable to open %s\n", stackname.GetChars());
+		return;
+	}
+	WriteCollapsedStacks(f, 0, "");
+	delete f;
+
+	Printf("Script profile written to %s and %s\n", filename, stackname.GetChars());
+}
+
+//==========================================================================
+//
+// CCMD vmprofile
+//
+//==========================================================================
+
+CCMD(vmprofile)
+{
+	if (argv.argc() >= 2)
+	{
+		if (stricmp(argv[1], "start") == 0)
+		{
+			StartProfiling(argv.argc() >= 3 && stricmp(argv[2], "lines") == 0);
+			return;
+		}
+		else if (stricmp(argv[1], "stop") == 0)
+		{
+			StopProfiling();
+			return;
+		}
+		else if (stricmp(argv[1], "reset") == 0)
+		{
+			ClearProfile();
+			return;
+		}
+		else if (stricmp(argv[1], "dump") == 0 && argv.argc() >= 3)
+		{
+			WriteProfile(argv[2], argv.argc() >= 4 ? (unsigned)atoi(argv[3]) : 0);
+			return;
+		}
+	}
+	Printf("Usage: vmprofile start [lines]\n"
+		"       vmprofile stop\n"
+		"       vmprofile reset\n"
+		"       vmprofile dump <filename> [limit]\n");
+}
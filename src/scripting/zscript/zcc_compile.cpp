@@ -42,7 +42,7 @@
 #include "v_text.h"
 #include "p_lnspec.h"
 
-FSharedStringArena VMStringConstants;
+FSharedStringArena VMStringConstants(&ZScriptMemory);
 bool isActor(PContainerType *type);
 
 
@@ -568,9 +568,11 @@ struct ZCC_FlagStmt : ZCC_Statement
 FString ZCC_PrintAST(ZCC_TreeNode *root);
 
 
+extern FMemoryAccount ZScriptMemory;
+
 struct ZCC_AST
 {
-	ZCC_AST() : TopNode(NULL) {}
+	ZCC_AST() : Strings(&ZScriptMemory), SyntaxArena(10*1024, &ZScriptMemory), TopNode(NULL) {}
 	ZCC_TreeNode *InitNode(size_t size, EZCCTreeNodeType type, ZCC_TreeNode *basis);
 
 	FSharedStringArena Strings;
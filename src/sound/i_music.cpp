@@ -132,7 +132,7 @@ void I_InitMusic (void)
 
 	snd_musicvolume.Callback ();
 
-	nomusic = !!Args->CheckParm("-nomusic") || !!Args->CheckParm("-nosound");
+	nomusic = !!Args->CheckParm("-nomusic") || !!Args->CheckParm("-nosound") || !!Args->CheckParm("-benchmark");
 
 #ifdef _WIN32
 	I_InitMusicWin32 ();
@@ -37,6 +37,9 @@
 #include "v_video.h"
 #include "v_text.h"
 #include "c_dispatch.h"
+#include "files.h"
+#include <mutex>
+#include <chrono>
 
 FStat *FStat::FirstStat;
 
@@ -139,3 +142,192 @@ CCMD (stat)
 		FStat::ToggleStat (argv[1]);
 	}
 }
+
+//==========================================================================
+//
+// Chrome trace recording
+//
+// Every thread that records events gets its own buffer and shows up as
+// its own track when the trace is loaded into chrome://tracing or
+// Perfetto. The buffers are only locked by their own thread while
+// recording, so the only contention is with trace_start/trace_stop.
+//
+//==========================================================================
+
+struct FTraceEvent
+{
+	const char *Name;	// nullptr for end events
+	int64_t Time;
+};
+
+struct FTraceThread
+{
+	int Id;
+	FString Name;
+	std::mutex Lock;
+	TArray<FTraceEvent> Events;
+	unsigned Dropped = 0;
+};
+
+enum
+{
+	MAX_TRACE_EVENTS = 1 << 21	// per thread
+};
+
+std::atomic<bool> FTraceScope::active { false };
+
+static std::mutex TraceThreadsLock;
+static TDeletingArray<FTraceThread *> TraceThreads;
+static thread_local FTraceThread *CurrentTraceThread;
+static int64_t TraceStartTime;
+static FString TraceFilename;
+
+static int64_t TraceTime()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static FTraceThread *GetTraceThread()
+{
+	if (CurrentTraceThread == nullptr)
+	{
+		// Thread records are never freed so that threads which exited
+		// while a trace was running can still be written out.
+		std::lock_guard<std::mutex> lock(TraceThreadsLock);
+		auto thread = new FTraceThread;
+		thread->Id = TraceThreads.Size() + 1;
+		thread->Name.Format("Thread %d", thread->Id);
+		TraceThreads.Push(thread);
+		CurrentTraceThread = thread;
+	}
+	return CurrentTraceThread;
+}
+
+static void AddTraceEvent(const char *name)
+{
+	FTraceThread *thread = GetTraceThread();
+	int64_t time = TraceTime();
+
+	std::lock_guard<std::mutex> lock(thread->Lock);
+	if (!FTraceScope::IsActive())
+	{
+		return;
+	}
+	if (thread->Events.Size() < MAX_TRACE_EVENTS)
+	{
+		thread->Events.Push({ name, time });
+	}
+	else
+	{
+		thread->Dropped++;
+	}
+}
+
+void FTraceScope::Begin(const char *name)
+{
+	AddTraceEvent(name);
+}
+
+void FTraceScope::End()
+{
+	AddTraceEvent(nullptr);
+}
+
+void FTraceScope::SetThreadName(const char *name)
+{
+	FTraceThread *thread = GetTraceThread();
+	std::lock_guard<std::mutex> lock(thread->Lock);
+	thread->Name = name;
+}
+
+static bool WriteTrace(const char *filename, unsigned &numevents, unsigned &dropped)
+{
+	FileWriter *f = FileWriter::Open(filename);
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(TraceThreadsLock);
+	const char *sep = "";
+
+	numevents = dropped = 0;
+	f->Printf("{\"traceEvents\":[\n");
+	for (auto thread : TraceThreads)
+	{
+		std::lock_guard<std::mutex> tlock(thread->Lock);
+		if (thread->Events.Size() == 0)
+		{
+			continue;
+		}
+
+		f->Printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", sep, thread->Id, thread->Name.GetChars());
+		sep = ",\n";
+		for (auto &ev : thread->Events)
+		{
+			double ts = (ev.Time - TraceStartTime) / 1000.;
+			if (ev.Name != nullptr)
+			{
+				f->Printf(",\n{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", ev.Name, ts, thread->Id);
+			}
+			else
+			{
+				f->Printf(",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", ts, thread->Id);
+			}
+		}
+		numevents += thread->Events.Size();
+		dropped += thread->Dropped;
+		thread->Events.Clear();
+		thread->Events.ShrinkToFit();
+	}
+	f->Printf("\n],\"displayTimeUnit\":\"ms\"}\n");
+	delete f;
+	return true;
+}
+
+CCMD (trace_start)
+{
+	if (FTraceScope::IsActive())
+	{
+		Printf ("A trace is already being recorded\n");
+		return;
+	}
+
+	TraceFilename = argv.argc() > 1 ? argv[1] : "trace.json";
+	{
+		std::lock_guard<std::mutex> lock(TraceThreadsLock);
+		for (auto thread : TraceThreads)
+		{
+			std::lock_guard<std::mutex> tlock(thread->Lock);
+			thread->Events.Clear();
+			thread->Dropped = 0;
+		}
+	}
+	FTraceScope::SetThreadName("Main thread");
+	TraceStartTime = TraceTime();
+	FTraceScope::active.store(true, std::memory_order_relaxed);
+	Printf ("Recording trace to %s\n", TraceFilename.GetChars());
+}
+
+CCMD (trace_stop)
+{
+	if (!FTraceScope::IsActive())
+	{
+		Printf ("No trace is being recorded\n");
+		return;
+	}
+	FTraceScope::active.store(false, std::memory_order_relaxed);
+
+	unsigned numevents, dropped;
+	if (!WriteTrace(TraceFilename, numevents, dropped))
+	{
+		Printf ("Could not write trace %s\n", TraceFilename.GetChars());
+		return;
+	}
+	Printf ("%u events written to %s\n", numevents, TraceFilename.GetChars());
+	if (dropped > 0)
+	{
+		Printf ("%u events were dropped because the buffer was full\n", dropped);
+	}
+}
@@ -35,6 +35,7 @@
 #define __STATS_H__
 
 #include "zstring.h"
+#include <atomic>
 
 #if !defined _WIN32 && !defined __APPLE__
 
@@ -222,6 +223,40 @@ private:
 	glcycle_t & clock;
 };
 
+// Records a named begin/end event pair for the Chrome trace that is being
+// written between trace_start and trace_stop. This costs a single branch
+// when no trace is running. The name must be a string literal because
+// only the pointer gets stored. Scopes are used on worker threads too,
+// so the flag is atomic.
+class FTraceScope
+{
+public:
+	static std::atomic<bool> active;
+
+	static bool IsActive() { return active.load(std::memory_order_relaxed); }
+
+	explicit FTraceScope(const char *name)
+		: recording(IsActive())
+	{
+		if (recording) Begin(name);
+	}
+
+	~FTraceScope()
+	{
+		if (recording) End();
+	}
+
+	FTraceScope(const FTraceScope&) = delete;
+	FTraceScope& operator=(const FTraceScope&) = delete;
+
+	static void Begin(const char *name);
+	static void End();
+	static void SetThreadName(const char *name);
+
+private:
+	bool recording;
+};
+
 
 
 class FStat
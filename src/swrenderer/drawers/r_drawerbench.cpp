@@ -0,0 +1,381 @@
+/*
+** r_drawerbench.cpp
+** Microbenchmark for the software renderer's column and span drawers
+**
+**---------------------------------------------------------------------------
+** Copyright 2018 GZDoom Development Team
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+** 3. The name of the author may not be used to endorse or promote products
+**    derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+** IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+** OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+** IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+** NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+** THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**---------------------------------------------------------------------------
+**
+** The drawers are fed with synthetic full screen walls, spans and sprites
+** rendered into an offscreen canvas, so the numbers only depend on the
+** drawers and the drawer threads, not on any level geometry.
+**
+*/
+
+#include <stddef.h>
+#include <chrono>
+#include <thread>
+
+#include "templates.h"
+#include "doomdef.h"
+#include "v_video.h"
+#include "c_dispatch.h"
+#include "r_state.h"
+#include "textures/textures.h"
+#include "r_draw.h"
+#include "r_thread.h"
+#include "swrenderer/r_memory.h"
+#include "swrenderer/r_renderthread.h"
+#include "swrenderer/r_swcolormaps.h"
+#include "swrenderer/scene/r_light.h"
+#include "swrenderer/textures/r_swtexture.h"
+#include "swrenderer/viewport/r_viewport.h"
+#include "swrenderer/viewport/r_walldrawer.h"
+#include "swrenderer/viewport/r_spandrawer.h"
+#include "swrenderer/viewport/r_spritedrawer.h"
+
+namespace swrenderer
+{
+	enum EDrawerBenchType
+	{
+		BENCH_Wall,
+		BENCH_Span,
+		BENCH_Sprite
+	};
+
+	struct FDrawerBenchTest
+	{
+		const char *Name;
+		EDrawerBenchType Type;
+		ERenderStyle Style;
+		double Alpha;
+		bool Masked;
+	};
+
+	static const FDrawerBenchTest DrawerBenchTests[] =
+	{
+		{ "wall",				BENCH_Wall,		STYLE_Normal,		1.0,	false },
+		{ "wall-masked",		BENCH_Wall,		STYLE_Normal,		1.0,	true },
+		{ "wall-translucent",	BENCH_Wall,		STYLE_Translucent,	0.5,	false },
+		{ "wall-additive",		BENCH_Wall,		STYLE_Add,			0.5,	false },
+		{ "span",				BENCH_Span,		STYLE_Normal,		1.0,	false },
+		{ "sprite",				BENCH_Sprite,	STYLE_Normal,		1.0,	false },
+		{ "sprite-translucent",	BENCH_Sprite,	STYLE_Translucent,	0.5,	false },
+		{ "sprite-additive",	BENCH_Sprite,	STYLE_Add,			0.5,	false },
+		{ "fuzz",				BENCH_Sprite,	STYLE_Fuzzy,		1.0,	false },
+	};
+
+	static const int DrawerBenchResolutions[][2] =
+	{
+		{ 320, 200 },
+		{ 640, 480 },
+		{ 1280, 720 },
+		{ 1920, 1080 },
+		{ 2560, 1440 },
+		{ 3840, 2160 },
+	};
+
+	class DrawerBenchmark
+	{
+	public:
+		DrawerBenchmark(FSoftwareTexture *walltex, FSoftwareTexture *spritetex)
+			: WallTex(walltex), SpriteTex(spritetex), Thread(new RenderThread(nullptr))
+		{
+		}
+
+		// Returns the number of pixels per second.
+		double Run(const FDrawerBenchTest &test, DCanvas *canvas, double seconds);
+
+	private:
+		void DrawFrame(const FDrawerBenchTest &test);
+		void DrawWalls(const FDrawerBenchTest &test);
+		void DrawSpans(const FDrawerBenchTest &test);
+		void DrawSprites(const FDrawerBenchTest &test);
+
+		FSoftwareTexture *WallTex;
+		FSoftwareTexture *SpriteTex;
+		std::unique_ptr<RenderThread> Thread;
+		TArray<short> FloorClip, CeilingClip;
+		int Width = 0, Height = 0;
+	};
+
+	double DrawerBenchmark::Run(const FDrawerBenchTest &test, DCanvas *canvas, double seconds)
+	{
+		using namespace std::chrono;
+
+		Width = canvas->GetWidth();
+		Height = canvas->GetHeight();
+		FloorClip.Resize(Width);
+		CeilingClip.Resize(Width);
+		for (int x = 0; x < Width; x++)
+		{
+			FloorClip[x] = Height;
+			CeilingClip[x] = 0;
+		}
+
+		Thread->Viewport->RenderTarget = canvas;
+		Thread->PrepareTexture(WallTex, DefaultRenderStyle());
+		Thread->PrepareTexture(SpriteTex, DefaultRenderStyle());
+		R_InitFuzzTable(canvas->GetPitch());
+		fuzzviewheight = Height - 2;
+
+		// One untimed frame to get the threads and the caches going.
+		DrawFrame(test);
+
+		int frames = 0;
+		auto start = steady_clock::now();
+		double elapsed;
+		do
+		{
+			DrawFrame(test);
+			frames++;
+			elapsed = duration_cast<duration<double>>(steady_clock::now() - start).count();
+		} while (elapsed < seconds || frames < 2);
+
+		return (double)frames * Width * Height / elapsed;
+	}
+
+	void DrawerBenchmark::DrawFrame(const FDrawerBenchTest &test)
+	{
+		Thread->FrameMemory->Clear();
+		Thread->DrawQueue->Clear();
+
+		switch (test.Type)
+		{
+		case BENCH_Wall:	DrawWalls(test);	break;
+		case BENCH_Span:	DrawSpans(test);	break;
+		case BENCH_Sprite:	DrawSprites(test);	break;
+		}
+
+		DrawerThreads::Execute(Thread->DrawQueue);
+		DrawerThreads::WaitForWorkers();
+	}
+
+	void DrawerBenchmark::DrawWalls(const FDrawerBenchTest &test)
+	{
+		RenderViewport *viewport = Thread->Viewport.get();
+		bool bgra = viewport->RenderTarget->IsBgra();
+		int texwidth = WallTex->GetPhysicalWidth();
+		int texheight = WallTex->GetPhysicalHeight();
+		int fracbits = 32 - WallTex->GetHeightBits();
+
+		WallDrawerArgs drawerargs;
+		drawerargs.SetStyle(test.Masked, test.Style == STYLE_Add, FLOAT2FIXED(test.Alpha), &NormalLight);
+		drawerargs.SetLight(0.0f, 0);
+		drawerargs.SetTextureFracBits(bgra ? FRACBITS : fracbits);
+		drawerargs.SetTextureVStep(bgra ? (uint32_t)(0x100000000LL / texheight) : (1u << fracbits));
+
+		for (int x = 0; x < Width; x++)
+		{
+			int col = x % texwidth;
+			if (bgra)
+			{
+				drawerargs.SetTexture((const uint8_t *)(WallTex->GetPixelsBgra() + col * texheight), nullptr, texheight);
+				drawerargs.SetTextureUPos(0);
+			}
+			else
+			{
+				drawerargs.SetTexture(WallTex->GetColumn(DefaultRenderStyle(), col, nullptr), nullptr, texheight);
+			}
+			drawerargs.SetDest(viewport, x, 0);
+			drawerargs.SetCount(Height);
+			drawerargs.SetTextureVPos(0);
+			drawerargs.DrawColumn(Thread.get());
+		}
+	}
+
+	void DrawerBenchmark::DrawSpans(const FDrawerBenchTest &test)
+	{
+		RenderViewport *viewport = Thread->Viewport.get();
+
+		SpanDrawerArgs drawerargs;
+		drawerargs.SetStyle(false, false, OPAQUE, &NormalLight);
+		drawerargs.SetLight(0.0f, 0);
+		drawerargs.SetTexture(Thread.get(), WallTex);
+		drawerargs.SetTextureLOD(0.0);
+		drawerargs.SetTextureUStep(1.0 / WallTex->GetWidth());
+		drawerargs.SetTextureVStep(0.0);
+
+		for (int y = 0; y < Height; y++)
+		{
+			drawerargs.SetTextureUPos(0.0);
+			drawerargs.SetTextureVPos((double)y / WallTex->GetHeight());
+			drawerargs.SetDestY(viewport, y);
+			drawerargs.SetDestX1(0);
+			drawerargs.SetDestX2(Width - 1);
+			drawerargs.DrawSpan(Thread.get());
+		}
+	}
+
+	void DrawerBenchmark::DrawSprites(const FDrawerBenchTest &test)
+	{
+		RenderViewport *viewport = Thread->Viewport.get();
+		FRenderStyle style = LegacyRenderStyles[test.Style];
+
+		ColormapLight light;
+		light.BaseColormap = &NormalLight;
+		light.ColormapNum = 0;
+
+		SpriteDrawerArgs drawerargs;
+		if (!drawerargs.SetStyle(viewport, style, FLOAT2FIXED(test.Alpha), 0, 0, light))
+			return;
+
+		// Stretch the sprite over the entire canvas and draw it unmasked so that
+		// every pixel gets touched exactly once.
+		double spryscale = (double)Height / SpriteTex->GetHeight();
+		fixed_t iscale = FLOAT2FIXED(1 / spryscale);
+		fixed_t xiscale = FLOAT2FIXED((double)SpriteTex->GetWidth() / Width);
+		fixed_t frac = 0;
+
+		for (int x = 0; x < Width; x++, frac += xiscale)
+		{
+			drawerargs.DrawMaskedColumn(Thread.get(), x, iscale, SpriteTex, frac, spryscale, 0.0, false, FloorClip.Data(), CeilingClip.Data(), style, true);
+		}
+	}
+
+	// Any power of two texture of at least 64x64 will do for walls and spans.
+	static FSoftwareTexture *FindDrawerBenchTexture(bool sprite)
+	{
+		for (int i = 0; i < TexMan.NumTextures(); i++)
+		{
+			FTexture *tex = TexMan.ByIndex(i);
+			if (tex == nullptr || !tex->isValid() || tex->isCanvas() || tex->isSprite() != sprite)
+				continue;
+
+			FSoftwareTexture *swtex = tex->GetSoftwareTexture();
+			int width = swtex->GetPhysicalWidth();
+			int height = swtex->GetPhysicalHeight();
+			if (sprite)
+			{
+				if (height >= 32)
+					return swtex;
+			}
+			else if (width >= 64 && height >= 64 && (width & (width - 1)) == 0 && (height & (height - 1)) == 0)
+			{
+				return swtex;
+			}
+		}
+		return nullptr;
+	}
+}
+
+//==========================================================================
+//
+// CCMD bench_drawers
+//
+// Runs every drawer at several resolutions and drawer thread counts and
+// prints the fill rate. The drawers are otherwise idle between frames so
+// this can be run from the console or with +bench_drawers on the command
+// line of a headless machine.
+//
+//==========================================================================
+
+CCMD (bench_drawers)
+{
+	using namespace swrenderer;
+
+	if (argv.argc() > 3)
+	{
+		Printf ("Usage: bench_drawers [pal|truecolor|all] [seconds per run]\n");
+		return;
+	}
+
+	bool pal = true, truecolor = true;
+	if (argv.argc() > 1)
+	{
+		pal = !stricmp(argv[1], "pal") || !stricmp(argv[1], "all");
+		truecolor = !stricmp(argv[1], "truecolor") || !stricmp(argv[1], "all");
+	}
+	double seconds = argv.argc() > 2 ? clamp(atof(argv[2]), 0.01, 60.) : 0.25;
+
+	FSoftwareTexture *walltex = FindDrawerBenchTexture(false);
+	FSoftwareTexture *spritetex = FindDrawerBenchTexture(true);
+	if (walltex == nullptr)
+	{
+		Printf ("No suitable texture found\n");
+		return;
+	}
+	if (spritetex == nullptr)
+	{
+		spritetex = walltex;
+	}
+
+	// The drawer threads clip their output to the screen's height.
+	int maxheight = screen->GetHeight();
+
+	int maxthreads = std::thread::hardware_concurrency();
+	if (maxthreads == 0)
+		maxthreads = 4;
+
+	TArray<int> threadcounts;
+	for (int i = 1; i < maxthreads; i <<= 1)
+		threadcounts.Push(i);
+	threadcounts.Push(maxthreads);
+
+	int savedmultithreaded = r_multithreaded;
+	int savedviewwindowx = viewwindowx;
+	int savedviewwindowy = viewwindowy;
+	int savedfuzzviewheight = fuzzviewheight;
+	viewwindowx = viewwindowy = 0;
+
+	DrawerBenchmark bench(walltex, spritetex);
+
+	Printf ("Drawer benchmark using %s and %s\n", walltex->GetTexture()->GetName().GetChars(), spritetex->GetTexture()->GetName().GetChars());
+	for (int format = 0; format < 2; format++)
+	{
+		bool bgra = format == 1;
+		if ((bgra && !truecolor) || (!bgra && !pal))
+			continue;
+
+		for (auto &res : DrawerBenchResolutions)
+		{
+			if (res[0] > MAXWIDTH || res[1] > maxheight)
+			{
+				Printf ("Skipping %dx%d, which is larger than the screen\n", res[0], res[1]);
+				continue;
+			}
+
+			DCanvas canvas(res[0], res[1], bgra);
+			for (int threads : threadcounts)
+			{
+				// 1 means one thread per core for this CVAR, 0 is single threaded.
+				r_multithreaded = threads == 1 ? 0 : threads;
+				for (auto &test : DrawerBenchTests)
+				{
+					double rate = bench.Run(test, &canvas, seconds);
+					Printf ("%-9s %-18s %4dx%-4d %2d threads %10.1f Mpixels/s\n", bgra ? "truecolor" : "pal",
+						test.Name, res[0], res[1], threads, rate / 1e6);
+				}
+			}
+		}
+	}
+
+	r_multithreaded = savedmultithreaded;
+	viewwindowx = savedviewwindowx;
+	viewwindowy = savedviewwindowy;
+	fuzzviewheight = savedfuzzviewheight;
+}
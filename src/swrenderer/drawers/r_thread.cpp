@@ -31,6 +31,7 @@
 #include "g_game.h"
 #include "g_level.h"
 #include "r_thread.h"
+#include "stats.h"
 #include "swrenderer/r_memory.h"
 #include "swrenderer/r_renderthread.h"
 #include <chrono>
@@ -99,6 +100,8 @@ void DrawerThreads::WaitForWorkers()
 {
 	using namespace std::chrono_literals;
 
+	FTraceScope trace("WaitForDrawers");
+
 	// Wait for workers to finish
 	auto queue = Instance();
 	std::unique_lock<std::mutex> end_lock(queue->end_mutex);
@@ -129,6 +132,10 @@ void DrawerThreads::WaitForWorkers()
 
 void DrawerThreads::WorkerMain(DrawerThread *thread)
 {
+	FString threadname;
+	threadname.Format("Drawer thread %d", (int)(thread - threads.data()));
+	FTraceScope::SetThreadName(threadname);
+
 	while (true)
 	{
 		// Wait until we are signalled to run:
@@ -150,20 +157,23 @@ void DrawerThreads::WorkerMain(DrawerThread *thread)
 		start_lock.unlock();
 
 		// Do the work:
-		if (r_debug_draw)
 		{
-			for (auto& command : list->commands)
+			FTraceScope trace("DrawerCommands");
+			if (r_debug_draw)
 			{
-				thread->debug_draw_pos++;
-				if (thread->debug_draw_pos < debug_draw_end)
-					command->Execute(thread);
+				for (auto& command : list->commands)
+				{
+					thread->debug_draw_pos++;
+					if (thread->debug_draw_pos < debug_draw_end)
+						command->Execute(thread);
+				}
 			}
-		}
-		else
-		{
-			for (auto& command : list->commands)
+			else
 			{
-				command->Execute(thread);
+				for (auto& command : list->commands)
+				{
+					command->Execute(thread);
+				}
 			}
 		}
 
@@ -38,6 +38,8 @@
 #include "r_data/colormaps.h"
 #include "r_memory.h"
 
+FMemoryAccount SWRenderMemory("Software renderer");
+
 void *RenderMemory::AllocBytes(int size)
 {
 	size = (size + 15) / 16 * 16; // 16-byte align
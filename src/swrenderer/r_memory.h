@@ -2,6 +2,9 @@
 
 #include <memory>
 #include <vector>
+#include "m_alloc.h"
+
+extern FMemoryAccount SWRenderMemory;
 
 // Memory needed for the duration of a frame rendering
 class RenderMemory
@@ -29,8 +32,8 @@ private:
 		
 	struct MemoryBlock
 	{
-		MemoryBlock() : Data(new uint8_t[BlockSize]), Position(0) { }
-		~MemoryBlock() { delete[] Data; }
+		MemoryBlock() : Data(new uint8_t[BlockSize]), Position(0) { SWRenderMemory.Add(BlockSize); }
+		~MemoryBlock() { delete[] Data; SWRenderMemory.Sub(BlockSize); }
 			
 		MemoryBlock(const MemoryBlock &) = delete;
 		MemoryBlock &operator=(const MemoryBlock &) = delete;
@@ -616,7 +616,7 @@ namespace swrenderer
 		if ((unsigned int)(sub->Index()) < Level->subsectors.Size())
 		{ // Only do it for the main BSP.
 			int lightlevel = (floorlightlevel + ceilinglightlevel) / 2;
-			for (int i = frontsector->Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = frontsector->Level->Particles[i].snext)
+			for (uint32_t i = frontsector->Level->ParticlesInSubsec[sub->Index()]; i != NO_PARTICLE; i = frontsector->Level->Particles[i].snext)
 			{
 				RenderParticle::Project(Thread, &frontsector->Level->Particles[i], sub->sector, lightlevel, FakeSide, foggy);
 			}
@@ -821,6 +821,8 @@ namespace swrenderer
 
 	void RenderOpaquePass::RenderScene(FLevelLocals *Level)
 	{
+		FTraceScope trace("BSP");
+
 		if (Thread->MainThread)
 			WallCycles.Clock();
 
@@ -142,6 +142,7 @@ namespace swrenderer
 
 	void RenderScene::RenderActorView(AActor *actor, bool dontmaplines)
 	{
+		FTraceScope trace("RenderScene");
 		WallCycles.Reset();
 		PlaneCycles.Reset();
 		MaskedCycles.Reset();
@@ -249,6 +250,7 @@ namespace swrenderer
 		// Wait for everyone to finish:
 		if (Threads.size() > 1)
 		{
+			FTraceScope trace("WaitForSceneThreads");
 			using namespace std::chrono_literals;
 			std::unique_lock<std::mutex> end_lock(end_mutex);
 			finished_threads++;
@@ -271,6 +273,7 @@ namespace swrenderer
 
 	void RenderScene::RenderThreadSlice(RenderThread *thread)
 	{
+		FTraceScope trace("RenderThreadSlice");
 		thread->DrawQueue->Clear();
 		thread->FrameMemory->Clear();
 		thread->Clip3D->Cleanup();
@@ -328,8 +331,13 @@ namespace swrenderer
 			std::unique_ptr<RenderThread> thread(new RenderThread(this, false));
 			auto renderthread = thread.get();
 			int start_run_id = run_id;
+			int threadindex = (int)Threads.size();
 			thread->thread = std::thread([=]()
 			{
+				FString threadname;
+				threadname.Format("Scene thread %d", threadindex);
+				FTraceScope::SetThreadName(threadname);
+
 				int last_run_id = start_run_id;
 				while (true)
 				{
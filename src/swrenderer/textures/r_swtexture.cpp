@@ -59,6 +59,29 @@ FSoftwareTexture *FTexture::GetSoftwareTexture()
 //
 //==========================================================================
 
+size_t FSoftwareTexture::MeasureMemory()
+{
+	size_t bytes = 0;
+	for (int i = 0; i < TexMan.NumTextures(); i++)
+	{
+		FTexture *tex = TexMan.ByIndex(i);
+		if (tex != nullptr && tex->SoftwareTexture != nullptr)
+		{
+			auto swtex = tex->SoftwareTexture;
+			bytes += swtex->Pixels.Max() + swtex->PixelsBgra.Max() * sizeof(uint32_t);
+		}
+	}
+	return bytes;
+}
+
+static FMemoryAccount SoftwareTextureMemory("Software textures", FSoftwareTexture::MeasureMemory);
+
+//==========================================================================
+//
+//
+//
+//==========================================================================
+
 FSoftwareTexture::FSoftwareTexture(FTexture *tex)
 {
 	mTexture = tex;
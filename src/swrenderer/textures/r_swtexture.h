@@ -116,6 +116,9 @@ public:
 	// Returns true if GetPixelsBgra includes mipmaps
 	virtual bool Mipmapped() { return true; }
 
+	// Memory used by the pixel buffers of all software textures
+	static size_t MeasureMemory();
+
 	// Returns a single column of the texture
 	virtual const uint8_t *GetColumn(int style, unsigned int column, const FSoftwareTextureSpan **spans_out);
 
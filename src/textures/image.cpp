@@ -40,7 +40,8 @@
 #include "w_wad.h"
 #include "files.h"
 
-FMemArena FImageSource::ImageArena(32768);
+static FMemoryAccount ImageSourceMemory("Texture image sources");
+FMemArena FImageSource::ImageArena(32768, &ImageSourceMemory);
 TArray<FImageSource *>FImageSource::ImageForLump;
 int FImageSource::NextID;
 static PrecacheInfo precacheInfo;